@@ -0,0 +1,75 @@
+//
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+//
+// compression_bench.cpp : cpu cost of gzip compression of log files (requires spdlog built with SPDLOG_ZLIB=ON)
+//
+
+#include <filesystem>
+
+#include "benchmark/benchmark.h"
+#include "spdlog/details/gzip.h"
+#include "spdlog/sinks/basic_file_sink.h"
+#include "spdlog/sinks/rotating_file_sink.h"
+#include "spdlog/spdlog.h"
+
+static void bench_logger(benchmark::State &state, std::shared_ptr<spdlog::logger> logger) {
+    int i = 0;
+    for (auto _ : state) {
+        logger->info("Hello logger: msg number {}...............", ++i);
+    }
+    state.SetBytesProcessed(state.iterations() * 64);
+}
+
+static std::shared_ptr<spdlog::logger> create_rotating(const std::string &name, spdlog::compression_mode mode, int level) {
+    const size_t file_size = 30 * 1024 * 1024;
+    const size_t rotating_files = 5;
+    const auto filename = "compression_logs/" + name + ".log";
+    auto sink = std::make_shared<spdlog::sinks::rotating_file_sink_st>(filename, file_size, rotating_files);
+    sink->set_background_rotation(true);
+    spdlog::file_compression compression;
+    compression.mode = mode;
+    compression.level = level;
+    sink->set_compression(compression);
+    return std::make_shared<spdlog::logger>(name, std::move(sink));
+}
+
+// compress a file of log lines, as the background rotation thread does
+static void bench_gzip_file(benchmark::State &state) {
+    const spdlog::filename_t src = "compression_logs/gzip_src.log";
+    const spdlog::filename_t dst = "compression_logs/gzip_src.log.gz";
+    {
+        auto logger = spdlog::basic_logger_st("gzip_src", src, true);
+        for (int i = 0; i < 200000; i++) {
+            logger->info("Hello logger: msg number {}...............", i);
+        }
+    }
+    const auto size = std::filesystem::file_size(src);
+    const auto level = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        spdlog::details::gzip_file(src, dst, level);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(size));
+}
+
+int main(int argc, char *argv[]) {
+    using spdlog::compression_mode;
+
+    // cost on the logging thread
+    benchmark::RegisterBenchmark("rotating_st", bench_logger, create_rotating("uncompressed", compression_mode::none, 0));
+    auto rotated = create_rotating("rotated", compression_mode::rotated, 6);
+    benchmark::RegisterBenchmark("rotating_st gzip rotated", bench_logger, std::move(rotated));
+    for (int level : {1, 6, 9}) {
+        auto name = "live_" + std::to_string(level);
+        benchmark::RegisterBenchmark(("rotating_st gzip live level " + std::to_string(level)).c_str(), bench_logger,
+                                     create_rotating(name, compression_mode::live, level));
+    }
+
+    // cost on the background thread, per rotated file
+    benchmark::RegisterBenchmark("gzip_file", bench_gzip_file)->Arg(1)->Arg(6)->Arg(9)->Unit(benchmark::kMillisecond);
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+}
@@ -56,6 +56,31 @@ void bench_disabled_macro(benchmark::State &state, std::shared_ptr<spdlog::logge
     }
 }
 
+// arguments that are costly to evaluate, logged at a level disabled at runtime (SPDLOG_ACTIVE_LEVEL allows info)
+static std::string costly_arg(int i) { return std::string(200, 'x') + std::to_string(i); }
+
+void bench_disabled_costly_args(benchmark::State &state, std::shared_ptr<spdlog::logger> logger) {
+    int i = 0;
+    for (auto _ : state) {
+        logger->info("Hello logger: msg number {}...............", costly_arg(i++));
+    }
+}
+
+void bench_disabled_costly_args_lazy_macro(benchmark::State &state, std::shared_ptr<spdlog::logger> logger) {
+    int i = 0;
+    benchmark::DoNotOptimize(i);  // prevent unused warnings
+    for (auto _ : state) {
+        SPDLOG_LOGGER_INFO_LAZY(logger, "Hello logger: msg number {}...............", costly_arg(i++));
+    }
+}
+
+void bench_disabled_costly_args_log_lazy(benchmark::State &state, std::shared_ptr<spdlog::logger> logger) {
+    int i = 0;
+    for (auto _ : state) {
+        logger->log_lazy(spdlog::level::info, [&] { return costly_arg(i++); });
+    }
+}
+
 void bench_disabled_macro_global_logger(benchmark::State &state, std::shared_ptr<spdlog::logger> logger) {
     spdlog::set_global_logger(std::move(logger));
     int i = 0;
@@ -107,6 +132,11 @@ int main(int argc, char *argv[]) {
     benchmark::RegisterBenchmark("disabled-at-compile-time (global logger)", bench_disabled_macro_global_logger, disabled_logger);
     benchmark::RegisterBenchmark("disabled-at-runtime", bench_logger, disabled_logger);
     benchmark::RegisterBenchmark("disabled-at-runtime (global logger)", bench_global_logger, disabled_logger);
+    benchmark::RegisterBenchmark("disabled-at-runtime (costly args)", bench_disabled_costly_args, disabled_logger);
+    benchmark::RegisterBenchmark("disabled-at-runtime (costly args, lazy macro)", bench_disabled_costly_args_lazy_macro,
+                                 disabled_logger);
+    benchmark::RegisterBenchmark("disabled-at-runtime (costly args, log_lazy)", bench_disabled_costly_args_log_lazy,
+                                 disabled_logger);
 
     auto null_logger_st = std::make_shared<spdlog::logger>("bench", std::make_shared<null_sink_st>());
     benchmark::RegisterBenchmark("null_sink_st (500_bytes c_str)", bench_c_string, std::move(null_logger_st));
@@ -0,0 +1,82 @@
+//
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+//
+
+//
+// page_cache_bench.cpp : throughput and page cache footprint of the file sinks page cache modes.
+// The "cached_MB" counter is how much of the log file is in the page cache after the run (linux only).
+//
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "spdlog/page_cache_mode.h"
+#include "spdlog/sinks/basic_file_sink.h"
+#include "spdlog/spdlog.h"
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// MB of the file resident in the page cache, -1 if unknown
+static double cached_mb(const std::string &filename) {
+#ifdef __linux__
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat st {};
+    double result = -1;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        const auto size = static_cast<size_t>(st.st_size);
+        void *addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (addr != MAP_FAILED) {
+            const auto page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            std::vector<unsigned char> pages((size + page_size - 1) / page_size);
+            if (::mincore(addr, size, pages.data()) == 0) {
+                size_t resident = 0;
+                for (auto page : pages) {
+                    resident += page & 1;
+                }
+                result = static_cast<double>(resident * page_size) / (1024 * 1024);
+            }
+            ::munmap(addr, size);
+        }
+    }
+    ::close(fd);
+    return result;
+#else
+    (void)filename;
+    return -1;
+#endif
+}
+
+static void bench_page_cache(benchmark::State &state, spdlog::page_cache_mode mode, const std::string &name) {
+    const std::string filename = "page_cache_logs/" + name + ".log";
+    auto sink = std::make_shared<spdlog::sinks::basic_file_sink_st>(filename, true);
+    sink->set_page_cache_mode(mode);
+    spdlog::logger logger(name, sink);
+    int i = 0;
+    for (auto _ : state) {
+        logger.info("Hello logger: msg number {}...............", ++i);
+    }
+    logger.flush();
+    state.SetBytesProcessed(state.iterations() * 64);
+    state.counters["cached_MB"] = cached_mb(filename);
+}
+
+int main(int argc, char *argv[]) {
+    using spdlog::page_cache_mode;
+
+    benchmark::RegisterBenchmark("basic_st page_cache keep", bench_page_cache, page_cache_mode::keep, "keep")->MinTime(3);
+    benchmark::RegisterBenchmark("basic_st page_cache drop", bench_page_cache, page_cache_mode::drop, "drop")->MinTime(3);
+    benchmark::RegisterBenchmark("basic_st page_cache bypass", bench_page_cache, page_cache_mode::bypass, "bypass")->MinTime(3);
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,101 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "./common.h"
+#include "./source_loc.h"
+
+namespace spdlog {
+//
+// Runtime switches of the SPDLOG_LOGGER_CALL sites (the SPDLOG_LOGGER_* and SPDLOG_* macros), e.g. to turn
+// on debug logging of one file or function in production without lowering the level of the logger.
+//
+// Each macro call site has a static call_site descriptor, registered on its first hit. Sites can be
+// enabled - logged regardless of the logger's level (the sinks levels still apply), disabled - never logged,
+// or follow the logger's level (the default). The rules are kept and applied to the sites registered later
+// too, the last matching rule wins. A disabled site costs one relaxed load of its own state.
+// Each site counts the messages it logged, to find the noisiest log statements (see call_sites()).
+//
+// file_glob is matched against the file name as given by __FILE__ and against its name without the path,
+// func_glob against the function name. Both support '*' and '?'.
+// e.g. spdlog::enable_call_sites("*/net/*");
+//      spdlog::disable_call_sites("parser.cpp", "tokenize");
+//
+// The macros evaluate their arguments only if the call logs. Not available with SPDLOG_NO_SOURCE_LOC.
+//
+// The registry keeps a pointer to each site, and never removes it: the SPDLOG_ macros must not be used in
+// shared libraries that are unloaded (dlclose, FreeLibrary) while spdlog is still used, otherwise the next
+// enable_call_sites()/disable_call_sites()/reset_call_sites(), call_sites() or reset_call_site_hits() reads
+// freed memory. Such libraries should define SPDLOG_NO_SOURCE_LOC, or call the logger methods directly.
+// A rule replaces the previous rule with the same globs, so the rules don't grow with repeated calls.
+//
+enum class call_site_state : std::uint8_t {
+    unregistered,  // not hit yet
+    normal,        // logged according to the logger's level
+    enabled,
+    disabled
+};
+
+struct call_site_info {
+    source_loc location;
+    level log_level;  // for macros given a runtime level, the level of the first hit
+    call_site_state state;
+    std::uint64_t hits;  // messages logged
+};
+
+SPDLOG_API void enable_call_sites(const std::string &file_glob, const std::string &func_glob = "*");
+SPDLOG_API void disable_call_sites(const std::string &file_glob, const std::string &func_glob = "*");
+// make the matching sites follow the logger's level again. ("*", "*") also drops all the rules.
+SPDLOG_API void reset_call_sites(const std::string &file_glob = "*", const std::string &func_glob = "*");
+
+// the registered call sites, most hits first
+SPDLOG_API std::vector<call_site_info> call_sites();
+SPDLOG_API void reset_call_site_hits();
+
+namespace details {
+class call_site_registry;
+}
+
+class SPDLOG_API call_site {
+public:
+    constexpr call_site(const char *filename, std::uint_least32_t line, const char *funcname, level lvl)
+        : location_{filename, line, funcname},
+          level_{lvl} {}
+
+    call_site(const call_site &) = delete;
+    call_site &operator=(const call_site &) = delete;
+
+    call_site_state state() const noexcept { return state_.load(std::memory_order_relaxed); }
+    const source_loc &location() const noexcept { return location_; }
+
+    // whether to log, given the state() read by the caller. registers the site on its first hit.
+    template <typename Logger>
+    bool should_log(call_site_state state, const Logger &logger, level lvl) noexcept {
+        if (state == call_site_state::unregistered) {
+            state = register_();
+        }
+        if (state == call_site_state::enabled || (state == call_site_state::normal && logger.should_log(lvl))) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    friend class details::call_site_registry;
+
+    // add to the registry and apply the rules. return the resulting state.
+    call_site_state register_() noexcept;
+
+    source_loc location_;
+    level level_;
+    std::atomic<call_site_state> state_{call_site_state::unregistered};
+    std::atomic<std::uint64_t> hits_{0};
+};
+}  // namespace spdlog
@@ -12,9 +12,14 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <type_traits>
 
 #include "./source_loc.h"
 
+#ifdef SPDLOG_MEMORY_RESOURCE
+    #include <memory_resource>
+#endif
+
 #if defined(SPDLOG_SHARED_LIB)
     #if defined(_WIN32)
         #ifdef spdlog_EXPORTS
@@ -41,6 +46,7 @@
 namespace spdlog {
 
 class formatter;
+struct log_field;
 
 namespace sinks {
 class sink;
@@ -53,12 +59,70 @@ using err_handler = std::function<void(const std::string &err_msg)>;
 using string_view_t = std::basic_string_view<char>;
 using wstring_view_t = std::basic_string_view<wchar_t>;
 
+#ifdef SPDLOG_MEMORY_RESOURCE
+// Memory resource used by spdlog's buffers (memory_buf_t, log_msg_buffer, async queue payloads and
+// formatter scratch buffers) when they grow beyond their inline storage. Defaults to new/delete.
+// Buffers keep the resource they were created with, so it must outlive them.
+// Pass nullptr to restore the default.
+// Only with SPDLOG_MEMORY_RESOURCE=ON - memory_buf_t is then not a fmt::memory_buffer (e.g. fmt::to_string
+// doesn't accept it), and each buffer looks up the current resource when created.
+SPDLOG_API void set_memory_resource(std::pmr::memory_resource *resource) noexcept;
+[[nodiscard]] SPDLOG_API std::pmr::memory_resource *get_memory_resource() noexcept;
+
+namespace details {
+// Allocator of memory_buf_t - allocates from the memory resource that was current when it was created.
+// Unlike std::pmr::polymorphic_allocator, it is assignable (needed to move buffers into queue slots).
+template <typename T>
+class buf_allocator {
+public:
+    using value_type = T;
+
+    buf_allocator() noexcept
+        : resource_{get_memory_resource()} {}
+    explicit buf_allocator(std::pmr::memory_resource *resource) noexcept
+        : resource_{resource} {}
+    template <typename U>
+    buf_allocator(const buf_allocator<U> &other) noexcept
+        : resource_{other.resource()} {}
+
+    [[nodiscard]] T *allocate(size_t n) { return static_cast<T *>(resource_->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T *p, size_t n) noexcept { resource_->deallocate(p, n * sizeof(T), alignof(T)); }
+
+    [[nodiscard]] std::pmr::memory_resource *resource() const noexcept { return resource_; }
+
+    template <typename U>
+    bool operator==(const buf_allocator<U> &other) const noexcept {
+        return resource_ == other.resource() || resource_->is_equal(*other.resource());
+    }
+    template <typename U>
+    bool operator!=(const buf_allocator<U> &other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    std::pmr::memory_resource *resource_;
+};
+}  // namespace details
+#endif
+
 namespace fmt_lib = fmt;
+#ifdef SPDLOG_MEMORY_RESOURCE
+using memory_buf_t = fmt::basic_memory_buffer<char, 250, details::buf_allocator<char>>;
+using wmemory_buf_t = fmt::basic_memory_buffer<wchar_t, 250, details::buf_allocator<wchar_t>>;
+#else
 using memory_buf_t = fmt::basic_memory_buffer<char, 250>;
 using wmemory_buf_t = fmt::basic_memory_buffer<wchar_t, 250>;
+#endif
+
+namespace details {
+// true if all the given args are key/value fields (see log_field.h)
+template <typename... Args>
+inline constexpr bool is_log_fields_v = sizeof...(Args) > 0 && (std::is_same_v<std::decay_t<Args>, log_field> && ...);
+}  // namespace details
 
+// argument lists made of key/value fields only are not format args (see logger's log_field overloads)
 template <typename... Args>
-using format_string_t = fmt::format_string<Args...>;
+using format_string_t = std::enable_if_t<!details::is_log_fields_v<Args...>, fmt::format_string<Args...>>;
 
 #define SPDLOG_LEVEL_TRACE 0
 #define SPDLOG_LEVEL_DEBUG 1
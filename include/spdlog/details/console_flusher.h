@@ -0,0 +1,73 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Flushing of the console sinks (stdout_sink_base, ansicolor_sink).
+//
+// When the file is a terminal, every message is flushed. Otherwise the messages are left in the stdio
+// buffer, and flushed at least every interval: when a message is written after the interval elapsed, and
+// by a timer thread if the sink gave a timer callback (the _mt sinks). The timer is started on the first
+// message that is not flushed right away, so sinks that never write to a pipe don't start a thread.
+//
+// Not thread safe - called under the sink's mutex, which the timer callback takes too.
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+#include "../common.h"
+#include "./null_mutex.h"
+#include "./periodic_worker.h"
+
+namespace spdlog {
+namespace details {
+
+class SPDLOG_API console_flusher {
+public:
+    // on_timer: flush the file under the sink's mutex. empty if the sink can't be flushed from another thread.
+    console_flusher(FILE *file, std::function<void()> on_timer);
+
+    // the timer callback of a sink: flush the file under the given mutex. empty for null_mutex (the _st sinks).
+    template <typename Mutex>
+    static std::function<void()> locked_flush(Mutex &mutex, FILE *file) {
+        if (std::is_same<Mutex, null_mutex>::value) {
+            return {};
+        }
+        return [&mutex, file] {
+            std::lock_guard<Mutex> lock(mutex);
+            std::fflush(file);
+        };
+    }
+
+    console_flusher(const console_flusher &) = delete;
+    console_flusher &operator=(const console_flusher &) = delete;
+
+    // a message was written at the given time: flush it now, or make sure the timer will
+    void written(log_clock::time_point time);
+
+    // 0 - flush every message. returns the previous timer, to be destroyed outside the sink's mutex.
+    [[nodiscard]] std::unique_ptr<periodic_worker> set_interval(std::chrono::milliseconds interval);
+
+    // true if every message is flushed (writing to a terminal, or interval 0)
+    bool line_flush() const noexcept { return terminal_ || interval_.count() == 0; }
+
+    bool timer_started() const noexcept { return timer_ != nullptr; }
+
+    // stop the timer. called without the sink's mutex, before destroying the sink.
+    void stop() { timer_.reset(); }
+
+private:
+    FILE *file_;
+    std::function<void()> on_timer_;
+    bool terminal_;
+    std::chrono::milliseconds interval_{std::chrono::seconds(1)};
+    log_clock::time_point last_flush_;
+    std::unique_ptr<periodic_worker> timer_;
+};
+
+}  // namespace details
+}  // namespace spdlog
@@ -0,0 +1,77 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Writer of a file opened for direct I/O (see page_cache_mode.h - page_cache_mode::bypass).
+//
+// The data is staged in two buffers aligned to the disk block size. When the active one is full it is
+// handed to a background thread, which writes it at its (aligned) file offset while the other one is
+// filled. The file is written in whole blocks: flush() writes the last partial block padded with zeros
+// and keeps it in the buffer, so the next write rewrites that block - the caller truncates the file to
+// size() after flush().
+//
+// RAII over the owned thread: the destructor waits for the pending write and joins the thread. It neither
+// flushes nor closes the file descriptor. Not thread safe - used by file_helper under the sink's mutex.
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "../common.h"
+#include "../filename_t.h"
+
+namespace spdlog {
+namespace details {
+
+class SPDLOG_API direct_writer {
+public:
+    // alignment of the buffers, file offsets and lengths - a multiple of the block size of common disks
+    static constexpr size_t alignment = 4096;
+
+    // fd: opened with os::open_direct(). file_size: the current size, writing continues from there.
+    // buffer_size is rounded up to the alignment. throw spdlog_ex on failure to read the last partial block.
+    direct_writer(int fd, size_t file_size, size_t buffer_size, filename_t filename);
+    ~direct_writer();
+
+    direct_writer(const direct_writer &) = delete;
+    direct_writer &operator=(const direct_writer &) = delete;
+
+    // throw spdlog_ex with the error of a background write, if any
+    void write(const char *data, size_t n);
+    // write everything, including the padded last block, and wait for it
+    void flush();
+    // size of the written data
+    size_t size() const noexcept { return offset_ + filled_; }
+
+private:
+    struct buffer_deleter {
+        void operator()(char *p) const noexcept;
+    };
+
+    // hand the full active buffer to the background thread and switch to the other one
+    void submit_();
+    // wait until the background thread is idle, throw its error if any
+    void wait_idle_(std::unique_lock<std::mutex> &lock);
+    void run_();
+
+    int fd_;
+    filename_t filename_;
+    size_t buffer_size_;
+    std::unique_ptr<char, buffer_deleter> buffers_[2];
+    int active_ = 0;
+    size_t filled_ = 0;  // bytes in the active buffer
+    size_t offset_ = 0;  // file offset of the active buffer
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    const char *pending_ = nullptr;  // buffer being written by the background thread
+    size_t pending_offset_ = 0;
+    int error_ = 0;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+}  // namespace details
+}  // namespace spdlog
@@ -3,10 +3,17 @@
 
 #pragma once
 
+#include <chrono>
+#include <memory>
 #include <tuple>
 
 #include "../common.h"
 #include "../file_event_handlers.h"
+#include "../file_sync_policy.h"
+#include "../page_cache_mode.h"
+#include "./direct_writer.h"
+#include "./file_syncer.h"
+#include "./gzip.h"
 
 namespace spdlog {
 namespace details {
@@ -14,31 +21,121 @@ namespace details {
 // Helper class for file sinks.
 // When failing to open a file, retry several times(5) with a delay interval(10 ms).
 // Throw spdlog_ex exception on errors.
+//
+// By default writes go through the FILE* buffer. If write_buffer_size > 0, writes are collected in an
+// internal page aligned buffer of that size instead, and submitted directly to the file descriptor
+// (writev on unix) when the buffer is full or on flush(), bypassing stdio and its locking.
+//
+// set_sync_policy() enables fsync according to the given file_sync_policy. The sinks call sync_by_policy()
+// after each write; when a sync is due the data is flushed to the kernel and a background file_syncer
+// thread syncs it to the disk. The time based sync is checked by sync_by_policy() and flush() only.
+//
+// size() is tracked by the writer: the size of the file when opened plus the bytes written since (including
+// what is still buffered, uncompressed if compressed), so it costs no flush or stat. resync() re-reads it from
+// the file system, e.g. after the file was truncated by another process.
+//
+// set_compression() makes the written file a gzip stream (see file_compression.h - compression_mode::live).
+//
+// set_preallocate(size) makes the files opened from then on preallocated to that size (fallocate where
+// available): the file is opened for writing at a position rather than for appending, so writes overwrite
+// the allocated blocks and don't grow the file. A truncated (or reused) file is not truncated when opened
+// but overwritten from its start. close() truncates the file to the written size; if the process dies the
+// file keeps its preallocated size, with zeros (or the old content of a reused file) after the written data.
+//
+// set_page_cache_mode() limits the page cache used by the written data (see page_cache_mode.h). With
+// page_cache_mode::bypass the data is written through a second descriptor opened for direct I/O, by a
+// details::direct_writer (its buffers are write_buffer_size if set, 1MB otherwise). The FILE* is still used
+// by the event handlers and for fsync.
+// Not thread safe - sinks use it under their mutex.
 
 class SPDLOG_API file_helper {
 public:
     file_helper() = default;
-    explicit file_helper(file_event_handlers event_handlers);
+    explicit file_helper(file_event_handlers event_handlers, size_t write_buffer_size = 0);
 
     file_helper(const file_helper &) = delete;
     file_helper &operator=(const file_helper &) = delete;
     ~file_helper();
 
     void open(const filename_t &fname, bool truncate = false);
+    // open fname like open() (including the open handlers) but return the file instead of switching to it.
+    // may run on another thread while this file_helper is in use - see details::rotation_worker.
+    std::FILE *prepare(const filename_t &fname, bool truncate) const;
+    // close the current file and continue with fp, a file returned by prepare() for fname
+    void adopt(std::FILE *fp, const filename_t &fname);
     void reopen(bool truncate);
     void flush() const;
     void sync() const;
     void close();
     void write(const memory_buf_t &buf) const;
+    // write several spans at once. spans that don't fit the buffer are passed to writev without copying.
+    void write(const string_view_t *spans, size_t count) const;
     size_t size() const;
+    // flush and re-read the size of the file from the file system. return the new size.
+    size_t resync();
     const filename_t &filename() const;
+    size_t write_buffer_size() const noexcept { return write_buffer_size_; }
+
+    void set_sync_policy(const file_sync_policy &policy);
+    const file_sync_policy &sync_policy() const noexcept { return sync_policy_; }
+    // request a background sync if the policy says it is due after writing a message of the given level
+    void sync_by_policy(level msg_level) const;
+    // number of background syncs done so far
+    size_t sync_counter() const noexcept { return syncer_ ? syncer_->sync_counter() : 0; }
+
+    // gzip what is written from now on with the given level (1..9), 0 to stop.
+    // switching ends the current gzip member, so the file stays valid.
+    void set_compression(int level);
+
+    // preallocate the files opened from now on to the given size, 0 to stop
+    void set_preallocate(size_t size) noexcept { preallocate_ = size; }
+    size_t preallocate() const noexcept { return preallocate_; }
+
+    // applies to the current file too. throw spdlog_ex if bypass is set with live compression.
+    void set_page_cache_mode(page_cache_mode mode);
+    page_cache_mode cache_mode() const noexcept { return cache_mode_; }
+    // the current file is written with direct I/O (page_cache_mode::bypass is in effect)
+    bool direct() const noexcept { return direct_ != nullptr; }
 
 private:
+    struct buffer_deleter {
+        void operator()(char *p) const noexcept;
+    };
+
+    void flush_buffer_() const;
+    void on_open_();
+    // open fname for writing at its start (truncate) or end, preallocated. nullptr on failure.
+    std::FILE *open_preallocated_(const filename_t &fname, bool truncate) const;
+    // set up and tear down the page cache mode of the current file
+    void start_cache_mode_();
+    void stop_cache_mode_();
+    // write the direct writer's data and cut the file back to its size
+    void flush_direct_() const;
+    // page_cache_mode::drop: start the writeback of the new data and drop what was written back
+    void drop_written_() const;
+
     const int open_tries_ = 5;
     const unsigned int open_interval_ = 10;
     std::FILE *fd_{nullptr};
     filename_t filename_;
     file_event_handlers event_handlers_;
+    size_t write_buffer_size_ = 0;
+    std::unique_ptr<char, buffer_deleter> write_buffer_;
+    mutable size_t buffered_ = 0;  // bytes pending in write_buffer_
+    file_sync_policy sync_policy_;
+    std::unique_ptr<file_syncer> syncer_;
+    std::unique_ptr<gzip_writer> gzip_;
+    mutable size_t unsynced_bytes_ = 0;  // bytes written since the last sync request
+    mutable std::chrono::steady_clock::time_point last_sync_;
+    size_t preallocate_ = 0;
+    bool overwrite_ = false;      // the current file was opened preallocated
+    mutable size_t written_ = 0;  // size of (position in) the current file, see size()
+    page_cache_mode cache_mode_ = page_cache_mode::keep;
+    std::unique_ptr<direct_writer> direct_;
+    int direct_fd_ = -1;
+    mutable size_t drop_mark_ = 0;        // written_ at the last drop_written_()
+    mutable size_t writeback_offset_ = 0;  // file offset up to which the writeback was started
+    mutable size_t dropped_offset_ = 0;    // file offset up to which the cache was dropped
 };
 }  // namespace details
 }  // namespace spdlog
@@ -0,0 +1,63 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Background thread that fsyncs (fdatasync where available) a file when requested, and
+// optionally periodically. Used by file_helper to apply file_sync_policy.
+//
+// The syncer works on its own duplicate of the file descriptor, so the file can be closed
+// (e.g. rotated) while a sync is in progress. A file replaced or closed with unsynced data
+// is synced by the thread before it closes its descriptor.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../common.h"
+
+namespace spdlog {
+namespace details {
+
+class SPDLOG_API file_syncer {
+public:
+    // interval > 0: also sync the file periodically if it was marked dirty
+    explicit file_syncer(std::chrono::milliseconds interval);
+    ~file_syncer();
+
+    file_syncer(const file_syncer &) = delete;
+    file_syncer &operator=(const file_syncer &) = delete;
+
+    // start syncing the given file (a descriptor owned by the syncer, -1 for none).
+    // the previous file is synced if dirty and closed by the thread.
+    void set_file(int fd);
+    // data reached the kernel - sync it on the next periodic wake up
+    void mark_dirty();
+    // data reached the kernel - sync it now
+    void request();
+
+    // number of syncs done so far
+    [[nodiscard]] size_t sync_counter() const noexcept { return sync_counter_.load(std::memory_order_relaxed); }
+
+private:
+    void run_();
+    void sync_fd_(int fd);
+
+    std::chrono::milliseconds interval_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    int fd_ = -1;
+    bool dirty_ = false;
+    bool requested_ = false;
+    bool stop_ = false;
+    std::vector<std::pair<int, bool>> retired_;  // replaced files and whether they are dirty
+    std::atomic<size_t> sync_counter_{0};
+    std::thread thread_;
+};
+
+}  // namespace details
+}  // namespace spdlog
@@ -8,6 +8,7 @@
 
 #include "../common.h"
 #include "../fmt/fmt.h"
+#include "../log_field.h"
 
 // Some fmt helpers to efficiently format and pad ints and strings
 namespace spdlog {
@@ -25,6 +26,27 @@ inline void append_int(T n, memory_buf_t &dest) {
     dest.append(i.data(), i.data() + i.size());
 }
 
+// append the field's value as text (e.g. 42, 3.14, true, some string)
+inline void append_field_value(const log_field &field, memory_buf_t &dest) {
+    switch (field.type) {
+        case log_field::value_type::boolean:
+            append_string_view(field.value.bool_value ? "true" : "false", dest);
+            break;
+        case log_field::value_type::int64:
+            append_int(field.value.int_value, dest);
+            break;
+        case log_field::value_type::uint64:
+            append_int(field.value.uint_value, dest);
+            break;
+        case log_field::value_type::float64:
+            fmt_lib::format_to(std::back_inserter(dest), SPDLOG_FMT_STRING("{}"), field.value.double_value);
+            break;
+        case log_field::value_type::string:
+            append_string_view(field.string_value(), dest);
+            break;
+    }
+}
+
 template <typename T>
 constexpr unsigned int count_digits_fallback(T n) {
     // taken from fmt: https://github.com/fmtlib/fmt/blob/8.0.1/include/fmt/format.h#L899-L912
@@ -0,0 +1,34 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "../common.h"
+
+namespace spdlog {
+namespace details {
+
+// Buffer to format a log message into: the calling thread's buffer, reused so that messages larger than
+// memory_buf_t's inline storage don't allocate every time, or a local one if the thread's is in use
+// (e.g. a formatter that logs), or if built with SPDLOG_NO_TLS or SPDLOG_MEMORY_RESOURCE (buffers keep
+// their resource, and a pool resource already reuses the memory).
+// The thread's buffer is released if it grew beyond max_kept_capacity.
+class SPDLOG_API format_buffer {
+public:
+    static constexpr size_t max_kept_capacity = 64 * 1024;
+
+    format_buffer() noexcept;
+    ~format_buffer();
+
+    format_buffer(const format_buffer &) = delete;
+    format_buffer &operator=(const format_buffer &) = delete;
+
+    memory_buf_t &get() noexcept { return *buf_; }
+
+private:
+    memory_buf_t local_;
+    memory_buf_t *buf_;
+};
+
+}  // namespace details
+}  // namespace spdlog
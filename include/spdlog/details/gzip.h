@@ -0,0 +1,45 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// gzip (zlib) compression of log files. See file_compression.h.
+// Throw spdlog_ex on errors, or if spdlog was built without SPDLOG_ZLIB.
+
+#include <cstdio>
+#include <memory>
+
+#include "../common.h"
+#include "../filename_t.h"
+
+namespace spdlog {
+namespace details {
+
+// Streaming gzip compression to a FILE*
+class SPDLOG_API gzip_writer {
+public:
+    explicit gzip_writer(int level);
+    ~gzip_writer();
+
+    gzip_writer(const gzip_writer &) = delete;
+    gzip_writer &operator=(const gzip_writer &) = delete;
+
+    void write(const char *data, size_t size, std::FILE *fp);
+    // write out everything compressed so far, so it can be decompressed (Z_SYNC_FLUSH)
+    void flush(std::FILE *fp);
+    // end the gzip member. the next write starts a new one.
+    void finish(std::FILE *fp);
+
+private:
+    struct impl;  // keeps zlib.h out of the headers
+    std::unique_ptr<impl> impl_;
+};
+
+// compress src to dst (overwritten if exists). src is not removed.
+SPDLOG_API void gzip_file(const filename_t &src, const filename_t &dst, int level);
+
+// return true if spdlog was built with gzip support
+SPDLOG_API bool gzip_available() noexcept;
+
+}  // namespace details
+}  // namespace spdlog
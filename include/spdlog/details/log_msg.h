@@ -6,9 +6,12 @@
 #include <string>
 
 #include "../common.h"
+#include "../log_field.h"
 
 namespace spdlog {
 namespace details {
+class mdc_data;
+
 struct SPDLOG_API log_msg {
     log_msg() = default;
     log_msg(log_clock::time_point log_time, source_loc loc, string_view_t logger_name, level lvl, string_view_t msg);
@@ -28,6 +31,14 @@ struct SPDLOG_API log_msg {
 
     source_loc source;
     string_view_t payload;
+
+    // structured key/value fields (not owned, see log_msg_buffer for an owning copy)
+    const log_field *fields{nullptr};
+    size_t fields_count{0};
+
+    // thread's mapped diagnostic context at the time of the log call (see mdc.h).
+    // not owned - log_msg_buffer keeps it alive by reference count.
+    const mdc_data *context{nullptr};
 };
 }  // namespace details
 }  // namespace spdlog
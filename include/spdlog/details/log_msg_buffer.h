@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <array>
+#include <memory>
+
 #include "./log_msg.h"
 
 namespace spdlog {
@@ -10,9 +13,14 @@ namespace details {
 
 // Extend log_msg with internal buffer to store its payload.
 // This is needed since log_msg holds string_views that points to stack data.
+// Key/value fields are copied to an inline array and their strings to the same buffer.
+// The mdc context block is shared (by reference count) rather than copied.
 
 class SPDLOG_API log_msg_buffer : public log_msg {
     memory_buf_t buffer;
+    std::array<log_field, SPDLOG_MAX_LOG_FIELDS> fields_buf_{};
+    std::shared_ptr<const mdc_data> context_holder_;
+    void copy_fields_();
     void update_string_views();
 
 public:
@@ -22,6 +30,9 @@ public:
     log_msg_buffer(log_msg_buffer &&other) noexcept;
     log_msg_buffer &operator=(const log_msg_buffer &other);
     log_msg_buffer &operator=(log_msg_buffer &&other) noexcept;
+
+    // copy orig_msg into this buffer, reusing its memory
+    void assign(const log_msg &orig_msg);
 };
 
 }  // namespace details
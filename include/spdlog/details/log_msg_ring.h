@@ -0,0 +1,63 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Fixed size circular log of messages stored in one preallocated byte arena.
+// Each message is serialized into a variable size record (header, key/value fields, logger name,
+// payload and field strings). When there is no room left, the oldest records are overwritten.
+// No memory is allocated after construction.
+
+#include <cstddef>
+#include <memory>
+
+#include "./log_msg.h"
+
+namespace spdlog {
+namespace details {
+
+class SPDLOG_API log_msg_ring {
+public:
+    log_msg_ring() = default;
+    // keep at most max_items messages in an arena of arena_size bytes
+    log_msg_ring(size_t max_items, size_t arena_size);
+    ~log_msg_ring();
+
+    log_msg_ring(const log_msg_ring &) = delete;
+    log_msg_ring &operator=(const log_msg_ring &) = delete;
+
+    // copy the message into the arena, overwriting the oldest messages if needed.
+    // messages larger than the whole arena are dropped.
+    void push_back(const log_msg &msg);
+
+    // view of the oldest message. valid until the next push_back() or pop_front().
+    [[nodiscard]] log_msg front() const;
+    void pop_front();
+
+    [[nodiscard]] bool empty() const noexcept { return count_ == 0; }
+    [[nodiscard]] size_t size() const noexcept { return count_; }
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+    // number of messages overwritten or dropped so far
+    [[nodiscard]] size_t overrun_counter() const noexcept { return overrun_counter_; }
+    void reset_overrun_counter() noexcept { overrun_counter_ = 0; }
+
+private:
+    struct record_header;
+
+    [[nodiscard]] record_header *header_at_(size_t offset) const noexcept;
+    [[nodiscard]] size_t record_size_(const log_msg &msg) const noexcept;
+    void write_record_(size_t offset, size_t record_size, const log_msg &msg);
+    void normalize_head_() noexcept;
+
+    std::unique_ptr<unsigned char[]> arena_;
+    size_t capacity_ = 0;
+    size_t max_items_ = 0;
+    size_t head_ = 0;  // offset of the oldest record
+    size_t tail_ = 0;  // offset of the next record
+    size_t count_ = 0;
+    size_t overrun_counter_ = 0;
+};
+
+}  // namespace details
+}  // namespace spdlog
@@ -75,10 +75,66 @@ SPDLOG_API std::string getenv(const char *field);
 // Return true on success.
 SPDLOG_API bool fsync(FILE *fp);
 
+// Duplicate the file descriptor of fp. The caller owns the result and closes it with close_fd().
+// Return -1 on failure.
+SPDLOG_API int dup_fd(FILE *fp) noexcept;
+
+// Close a file descriptor returned by dup_fd()
+SPDLOG_API void close_fd(int fd) noexcept;
+
+// Flush the file data (but not necessarily its metadata) to the disk - fdatasync where available.
+// Return true on success.
+SPDLOG_API bool fdatasync(int fd) noexcept;
+
+// Allocate the disk blocks of the first size bytes of the file, extending it if smaller (fallocate where available).
+// Return false if failed or not supported.
+SPDLOG_API bool preallocate(FILE *fp, size_t size) noexcept;
+
+// Offset of the file descriptor of fp (flush fp first).
+// Throw spdlog_ex on failure.
+SPDLOG_API size_t file_offset(FILE *fp);
+
+// Set the position of fp to the given offset from the start of the file, with 64 bit offsets where long
+// is 32 bit (fseeko, _fseeki64). Return true on success.
+SPDLOG_API bool seek(FILE *fp, size_t offset) noexcept;
+
+// Truncate (or extend) the file to the given size (flush fp first).
+// Return true on success.
+SPDLOG_API bool truncate(FILE *fp, size_t size) noexcept;
+
+// Open an existing file for reading and writing, bypassing the page cache (O_DIRECT, F_NOCACHE on apple,
+// FILE_FLAG_NO_BUFFERING on windows). Reads and writes must be aligned to the disk block size in offset,
+// length and memory address.
+// Return the file descriptor (close with close_fd()), or -1 if failed or not supported.
+SPDLOG_API int open_direct(const filename_t &filename) noexcept;
+
+// Write n bytes to the file descriptor at the given offset. Retries on partial writes and EINTR.
+// Return true on success.
+SPDLOG_API bool pwrite_bytes(int fd, const void *ptr, size_t n, size_t offset) noexcept;
+
+// Read up to n bytes from the file descriptor at the given offset.
+// Return the number of bytes read (less than n at the end of the file), or -1 on failure.
+SPDLOG_API long long pread_bytes(int fd, void *ptr, size_t n, size_t offset) noexcept;
+
+// Start writing the given range of the file to the disk, without waiting for it (sync_file_range on linux).
+// len 0 - to the end of the file.
+// Return false if failed or not supported.
+SPDLOG_API bool start_writeback(FILE *fp, size_t offset, size_t len) noexcept;
+
+// Advise the os to drop the given range of the file from the page cache (posix_fadvise(POSIX_FADV_DONTNEED)).
+// Pages not written to the disk yet are kept. len 0 - to the end of the file.
+// Return false if failed or not supported.
+SPDLOG_API bool drop_cache(FILE *fp, size_t offset, size_t len) noexcept;
+
 // Do non-locking fwrite if possible by the os or use the regular locking fwrite
 // Return true on success.
 SPDLOG_API bool fwrite_bytes(const void *ptr, const size_t n_bytes, FILE *fp);
 
+// Write the given spans directly to the file descriptor of fp, bypassing the FILE* buffer and its lock
+// (writev on unix). Retries on partial writes and EINTR.
+// Return true on success.
+SPDLOG_API bool write_spans(const string_view_t *spans, size_t count, FILE *fp);
+
 //
 // std::filesystem wrapper functions
 //
@@ -106,6 +162,10 @@ SPDLOG_API bool rename(const filename_t &filename1, const filename_t &filename2)
 // Return if file exists.
 SPDLOG_API bool path_exists(const filename_t &filename) noexcept;
 
+// Make link a symbolic link to target, replacing link if it exists (atomically on posix).
+// Return true on success.
+SPDLOG_API bool create_symlink(const filename_t &target, const filename_t &link) noexcept;
+
 // Return file path and its extension:
 //
 // "mylog.txt" => ("mylog", ".txt")
@@ -0,0 +1,69 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Index of the files written by a time based file sink (see sinks/time_file_sink.h), oldest first, used to
+// delete the oldest files over a number of files and a total size.
+//
+// It is built once from a single scan of the log directory - so files left by previous executions count too -
+// and then updated as the sink rotates, so startup time doesn't depend on how many files are retained.
+// Compressed files (name + ".gz") are indexed under their uncompressed name. The sizes of the files rotated
+// since the scan are their uncompressed sizes, even if they are compressed later.
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include "../common.h"
+#include "../filename_t.h"
+
+namespace spdlog {
+namespace details {
+
+class SPDLOG_API retention_index {
+public:
+    struct entry {
+        filename_t filename;
+        size_t size;
+    };
+
+    // max_files, max_bytes: the limits, 0 means no limit
+    retention_index(size_t max_files, size_t max_bytes) noexcept;
+
+    // index the files in the directory of sample1 that are named like sample1 and sample2, ordered by their
+    // modification time. sample1 and sample2 are two names of the sink's series, rendered from times that
+    // differ in every digit (e.g. 2000-01-01 00:00:00 and 1911-12-22 11:11:11): the positions where they
+    // differ by a digit match any digit. if they differ in length (e.g. month names), no file is indexed:
+    // the files of previous runs are not expired.
+    void scan(const filename_t &sample1, const filename_t &sample2);
+
+    bool scanned() const noexcept { return scanned_; }
+
+    // the file currently written: add it as the newest file, or update its size if already the newest
+    void set_current(const filename_t &filename, size_t size);
+
+    // remove the file from the index (e.g. it was deleted)
+    void remove(const filename_t &filename);
+
+    // remove the oldest files over the limits from the index and return them, oldest first.
+    // the newest (current) file is never returned.
+    std::vector<filename_t> expire();
+
+    void set_limits(size_t max_files, size_t max_bytes) noexcept;
+
+    // the indexed files, oldest first
+    const std::deque<entry> &entries() const noexcept { return files_; }
+    size_t files() const noexcept { return files_.size(); }
+    size_t total_bytes() const noexcept { return total_bytes_; }
+
+private:
+    std::deque<entry> files_;
+    size_t total_bytes_ = 0;
+    size_t max_files_;
+    size_t max_bytes_;
+    bool scanned_ = false;
+};
+
+}  // namespace details
+}  // namespace spdlog
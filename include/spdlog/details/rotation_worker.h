@@ -0,0 +1,91 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Background maintenance thread of a rotating sink.
+//
+// Runs the file system work of rotations (renames, deletions) in order, off the sink's mutex,
+// and opens the next file ahead of time so that a rotation only has to switch to it.
+// Errors of the background tasks are kept and rethrown on the logging thread by check_error().
+//
+// RAII over the owned thread: the destructor runs the pending tasks, closes the prepared file if it
+// was not taken, and joins the thread.
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "../common.h"
+#include "./file_helper.h"
+
+namespace spdlog {
+
+// Time the logging thread was blocked by rotations of a sink
+struct rotation_stats {
+    size_t rotations = 0;
+    std::chrono::nanoseconds last_stall{0};
+    std::chrono::nanoseconds max_stall{0};
+    std::chrono::nanoseconds total_stall{0};
+
+    void add(std::chrono::nanoseconds stall) noexcept {
+        ++rotations;
+        last_stall = stall;
+        total_stall += stall;
+        if (stall > max_stall) {
+            max_stall = stall;
+        }
+    }
+};
+
+namespace details {
+
+class SPDLOG_API rotation_worker {
+public:
+    rotation_worker();
+    ~rotation_worker();
+
+    rotation_worker(const rotation_worker &) = delete;
+    rotation_worker &operator=(const rotation_worker &) = delete;
+
+    // run the task on the worker thread. exceptions are kept for check_error().
+    void post(std::function<void()> task);
+
+    // open fname with helper.prepare() on the worker thread, to be taken by take_prepared().
+    // helper must outlive the worker.
+    void prepare(const file_helper &helper, filename_t fname, bool truncate);
+
+    // return the file opened by prepare() for fname, or nullptr if it is not ready (or failed).
+    // the caller owns the returned file. if nullptr is returned the pending prepare() is cancelled,
+    // so the caller can open the file itself.
+    std::FILE *take_prepared(const filename_t &fname);
+
+    // wait until all the posted tasks are done
+    void wait_idle();
+
+    // throw spdlog_ex with the first error of the background tasks since the last call, if any
+    void check_error();
+
+private:
+    void run_();
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> tasks_;
+    bool busy_ = false;
+    bool stop_ = false;
+    std::string error_;
+    filename_t wanted_name_;  // file of the last prepare(), empty if cancelled
+    bool preparing_ = false;  // the worker is opening wanted_name_
+    std::FILE *prepared_ = nullptr;
+    filename_t prepared_name_;
+    std::thread thread_;
+};
+
+}  // namespace details
+}  // namespace spdlog
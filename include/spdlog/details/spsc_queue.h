@@ -0,0 +1,123 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// single producer-single consumer bounded queue of preallocated slots.
+// the producer fills the slot returned by write_slot() in place and publishes it with push(),
+// the consumer reads front() in place and releases it with pop(). slots are reused, so items
+// that own memory (e.g. log_msg_buffer) don't allocate once warmed up.
+// pushing and popping are lock free. the wait_..() functions block on a condition variable, which
+// the other side only locks and notifies if someone is waiting.
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace spdlog {
+namespace details {
+
+template <typename T>
+class spsc_queue {
+public:
+    using item_type = T;
+
+    explicit spsc_queue(size_t max_items)
+        : slots_(max_items + 1) {}  // one slot is kept empty to tell full from empty
+
+    spsc_queue(const spsc_queue &) = delete;
+    spsc_queue &operator=(const spsc_queue &) = delete;
+
+    // producer: the slot to fill, nullptr if the queue is full
+    T *try_write_slot() noexcept {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (next_(tail) == head_.load()) {
+            return nullptr;
+        }
+        return &slots_[tail];
+    }
+
+    // producer: the slot to fill. block until there is room.
+    T &write_slot() {
+        T *slot = try_write_slot();
+        if (slot == nullptr) {
+            wait_([&] { return (slot = try_write_slot()) != nullptr; });
+        }
+        return *slot;
+    }
+
+    // producer: publish the filled slot
+    void push() {
+        tail_.store(next_(tail_.load(std::memory_order_relaxed)));
+        notify_();
+    }
+
+    // consumer: the oldest item, nullptr if the queue is empty
+    T *front() noexcept {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load()) {
+            return nullptr;
+        }
+        return &slots_[head];
+    }
+
+    // consumer: the oldest item. block until there is one.
+    T &wait_front() {
+        T *item = front();
+        if (item == nullptr) {
+            wait_([&] { return (item = front()) != nullptr; });
+        }
+        return *item;
+    }
+
+    // consumer: release the front item
+    void pop() {
+        head_.store(next_(head_.load(std::memory_order_relaxed)));
+        notify_();
+    }
+
+    // producer: block until the consumer popped everything
+    void wait_empty() {
+        wait_([this] { return empty(); });
+    }
+
+    bool empty() const noexcept { return head_.load() == tail_.load(); }
+
+    size_t size() const noexcept {
+        const size_t head = head_.load();
+        const size_t tail = tail_.load();
+        return tail >= head ? tail - head : tail + slots_.size() - head;
+    }
+
+    size_t capacity() const noexcept { return slots_.size() - 1; }
+
+private:
+    size_t next_(size_t index) const noexcept { return index + 1 == slots_.size() ? 0 : index + 1; }
+
+    // the waiting flag and the head/tail indices are seq_cst, so either the waiter sees the other side's
+    // update in its predicate, or the other side sees the flag and notifies.
+    template <typename Pred>
+    void wait_(Pred pred) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waiters_.fetch_add(1);
+        cv_.wait(lock, pred);
+        waiters_.fetch_sub(1);
+    }
+
+    void notify_() {
+        if (waiters_.load() > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv_.notify_all();
+        }
+    }
+
+    std::vector<T> slots_;
+    alignas(64) std::atomic<size_t> head_{0};  // written by the consumer
+    alignas(64) std::atomic<size_t> tail_{0};  // written by the producer
+    std::atomic<int> waiters_{0};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+}  // namespace details
+}  // namespace spdlog
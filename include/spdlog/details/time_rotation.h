@@ -0,0 +1,63 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Rotation periods of the time based file sinks (see sinks/time_file_sink.h).
+//
+// The periods have a fixed length and restart every day at local midnight plus an offset, e.g.
+// daily at 02:30 is (24h, 2h30m), hourly is (1h, 0), every 15 minutes is (15m, 0). If the length doesn't
+// divide the day, the last period of the day is shorter.
+//
+// Local times are computed from the utc offset with plain calendar arithmetic (no mktime). The offset is
+// looked up with localtime() at most about twice a day: it is assumed to hold for a day when it is the
+// same at both ends of that day, so DST changes take effect at the first boundary after them.
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+
+#include "../common.h"
+#include "../filename_t.h"
+
+namespace spdlog {
+namespace details {
+
+class SPDLOG_API time_rotation {
+public:
+    struct period {
+        log_clock::time_point start;
+        log_clock::time_point end;  // start of the next period - the rotation time
+        std::tm start_tm{};         // local time of start
+    };
+
+    // throw spdlog_ex if interval is not in (0, 24h] or offset is not in [0, 24h)
+    explicit time_rotation(std::chrono::minutes interval, std::chrono::minutes offset = std::chrono::minutes::zero());
+
+    // the period that contains tp
+    period period_of(log_clock::time_point tp);
+
+    std::chrono::minutes interval() const noexcept { return interval_; }
+    std::chrono::minutes offset() const noexcept { return offset_; }
+
+    // days since 1970-01-01 of the given date (proleptic gregorian calendar), and back
+    static std::int64_t days_from_civil(std::int64_t year, unsigned month, unsigned day) noexcept;
+    static void civil_from_days(std::int64_t days, std::int64_t &year, unsigned &month, unsigned &day) noexcept;
+
+private:
+    // utc offset in seconds at the given utc time
+    std::int64_t utc_offset_(std::int64_t utc_seconds);
+
+    std::chrono::minutes interval_;
+    std::chrono::minutes offset_;
+    std::int64_t cached_offset_ = 0;
+    int cached_isdst_ = -1;
+    std::int64_t cache_from_ = 0;  // cached_offset_ holds in [cache_from_, cache_until_]
+    std::int64_t cache_until_ = -1;
+};
+
+// the filename with suffix inserted before its extension, e.g. ("logs/app.txt", "_2024-01-31") -> "logs/app_2024-01-31.txt"
+SPDLOG_API filename_t insert_before_extension(const filename_t &filename, string_view_t suffix);
+
+}  // namespace details
+}  // namespace spdlog
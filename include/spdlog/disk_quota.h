@@ -0,0 +1,164 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include "./common.h"
+#include "./filename_t.h"
+
+namespace spdlog {
+//
+// Limit of the disk space used by the files of many file sinks, e.g. all the file sinks of the process.
+// Each sink only bounds its own files (max_size * max_files), so many loggers can't be bounded together
+// without this.
+//
+// Share one instance between the sinks (set_disk_quota() of rotating_file_sink with monotonic naming and
+// of the time based sinks). It tracks the size of their files - the files they retain when registered,
+// plus what they write - and when the total exceeds max_bytes it deletes the oldest rotated files across
+// all the sinks. The files currently written are never deleted.
+// Optionally, when the usage is above a ratio of the quota, low priority sinks write only one in every
+// N messages (see set_sampling()).
+//
+// The sizes of the files rotated after registration are their uncompressed sizes, even if compressed later.
+// The files of a sink are not tracked anymore once it is destroyed or registered with another quota.
+//
+// e.g. auto quota = std::make_shared<spdlog::disk_quota>(1024 * 1024 * 1024);
+//      rotating_sink->set_disk_quota(quota);
+//      daily_sink->set_disk_quota(quota, spdlog::quota_priority::low);
+//
+enum class quota_priority {
+    normal,
+    low  // sampled when the quota is nearly used up
+};
+
+struct disk_quota_stats {
+    size_t max_bytes = 0;
+    size_t bytes_on_disk = 0;  // tracked size of the files of the registered sinks
+    size_t bytes_written = 0;  // written by the registered sinks since they registered
+    size_t files = 0;          // tracked files, including the current ones
+    size_t sinks = 0;
+    size_t evicted_files = 0;
+    size_t evicted_bytes = 0;
+    size_t sampled_out = 0;  // messages dropped by the sampling of low priority sinks
+    bool sampling = false;   // low priority sinks are sampled now
+};
+
+namespace details {
+class quota_client;
+}
+
+class SPDLOG_API disk_quota {
+public:
+    // max_bytes: 0 - no limit, only track
+    explicit disk_quota(size_t max_bytes);
+
+    disk_quota(const disk_quota &) = delete;
+    disk_quota &operator=(const disk_quota &) = delete;
+
+    // change the limit. the oldest files over it are deleted now.
+    void set_max_bytes(size_t max_bytes);
+
+    // when the tracked size is over usage_ratio * max_bytes, low priority sinks write only one in every
+    // keep_one_in messages. keep_one_in <= 1 disables the sampling.
+    void set_sampling(double usage_ratio, size_t keep_one_in);
+
+    disk_quota_stats stats() const;
+
+    // delete the oldest rotated files while the tracked size is over the limit
+    void enforce();
+
+private:
+    friend class details::quota_client;
+
+    struct tracked_file {
+        filename_t filename;
+        size_t size;
+        std::filesystem::file_time_type time;
+    };
+
+    struct member {
+        quota_priority priority;
+        std::deque<tracked_file> rotated;  // oldest first
+        filename_t current;
+        size_t current_size = 0;
+    };
+
+    // add the tracked bytes, update the sampling state and enforce the limit
+    void add_bytes_(size_t n);
+    void sub_bytes_(size_t n);
+    // sampling_bytes_ from the limit and the sampling ratio. under mutex_.
+    void update_sampling_bytes_();
+
+    mutable std::mutex mutex_;
+    std::list<member> members_;  // guarded by mutex_
+    size_t files_ = 0;           // guarded by mutex_
+    size_t evicted_files_ = 0;   // guarded by mutex_
+    size_t evicted_bytes_ = 0;   // guarded by mutex_
+    double sampling_ratio_ = 1;  // guarded by mutex_
+    std::atomic<size_t> max_bytes_;
+    std::atomic<size_t> total_bytes_{0};
+    std::atomic<size_t> rotated_files_{0};  // files that can be evicted
+    std::atomic<size_t> bytes_written_{0};
+    std::atomic<size_t> sampling_bytes_{0};  // 0 if no sampling
+    std::atomic<size_t> keep_one_in_{0};
+    std::atomic<size_t> sampled_out_{0};
+    std::atomic<bool> sampling_{false};
+};
+
+namespace details {
+//
+// Registration of a file sink with a disk_quota. Used by the sink under its mutex.
+//
+class SPDLOG_API quota_client {
+public:
+    quota_client(std::shared_ptr<disk_quota> quota, quota_priority priority);
+    ~quota_client();
+
+    quota_client(const quota_client &) = delete;
+    quota_client &operator=(const quota_client &) = delete;
+
+    // a file of the sink that is not written anymore, e.g. of a previous run. its size and age are read
+    // from the file system (<filename>.gz if compressed). ignored if it doesn't exist.
+    void add_existing(const filename_t &filename);
+
+    // the sink writes to filename, of the given size. the previous current file becomes a rotated file.
+    void set_current(const filename_t &filename, size_t size);
+
+    // the sink deleted the file itself
+    void removed(const filename_t &filename);
+
+    // count the bytes written to the current file. delete the oldest files if over the quota.
+    void written(size_t n) {
+        state_->current_size += n;
+        quota_->bytes_written_.fetch_add(n, std::memory_order_relaxed);
+        quota_->add_bytes_(n);
+    }
+
+    // false if the message should be dropped by the sampling of low priority sinks
+    bool sample() {
+        if (state_->priority != quota_priority::low || !quota_->sampling_.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        const size_t keep_one_in = quota_->keep_one_in_.load(std::memory_order_relaxed);
+        if (keep_one_in <= 1 || ++sample_counter_ % keep_one_in == 0) {
+            return true;
+        }
+        quota_->sampled_out_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+private:
+    std::shared_ptr<disk_quota> quota_;
+    std::list<disk_quota::member>::iterator state_;  // current_size and priority are only used by this client
+    size_t sample_counter_ = 0;
+};
+}  // namespace details
+}  // namespace spdlog
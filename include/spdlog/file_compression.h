@@ -0,0 +1,31 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "./common.h"
+
+namespace spdlog {
+//
+// gzip compression of file sinks output.
+// Requires spdlog to be built with SPDLOG_ZLIB=ON - enabling it otherwise throws spdlog_ex.
+//
+// compression_mode::rotated - files are written uncompressed, and compressed to <filename>.gz by the
+//      background rotation thread once rotated (see set_background_rotation()).
+// compression_mode::live - the file itself is a gzip stream. flush() ends a deflate block, so everything
+//      logged before it can be decompressed even if the process dies. Each time the file is opened a new
+//      gzip member is started (concatenated members are a valid gzip file).
+//      The size limit of rotating_file_sink applies to the uncompressed data.
+//      The file event handlers must not write to the file.
+//
+// e.g. spdlog::file_compression compression;
+//      compression.mode = spdlog::compression_mode::rotated;
+//      rotating_sink->set_compression(compression);
+//
+enum class compression_mode { none, rotated, live };
+
+struct file_compression {
+    compression_mode mode = compression_mode::none;
+    int level = 6;  // 1 (fastest) .. 9 (smallest)
+};
+}  // namespace spdlog
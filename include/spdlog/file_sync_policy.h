@@ -0,0 +1,37 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <chrono>
+
+#include "./common.h"
+
+namespace spdlog {
+//
+// Durability policy of file sinks - when to fsync the written data to the disk.
+// The fsync runs on a background thread, so logging never waits for the disk. The logging thread
+// only flushes the written data to the kernel when a sync is due.
+// The triggers can be combined. All are disabled by default (never fsync).
+//
+// e.g. bound the data lost on power failure to 1 second, and sync errors right away:
+//      spdlog::file_sync_policy policy;
+//      policy.every = std::chrono::seconds(1);
+//      policy.on_level = spdlog::level::err;
+//      file_sink->set_sync_policy(policy);
+//
+struct file_sync_policy {
+    // sync after this many bytes were written since the last sync (0 - disabled)
+    size_t every_bytes = 0;
+    // sync the written data at this interval (0 - disabled).
+    // the interval is checked when a message is logged, and the background thread only syncs data that
+    // was flushed to the kernel. so the bound holds only while messages keep arriving: after the last
+    // message, its data stays buffered until the next flush (see logger::flush_on()) or until the file
+    // is closed. the background thread syncs flushed data within the interval.
+    std::chrono::milliseconds every{0};
+    // sync after logging a message of this level or higher (off - disabled)
+    level on_level = level::off;
+
+    [[nodiscard]] bool enabled() const noexcept { return every_bytes > 0 || every.count() > 0 || on_level != level::off; }
+};
+}  // namespace spdlog
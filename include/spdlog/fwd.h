@@ -6,6 +6,7 @@
 namespace spdlog {
 class logger;
 class formatter;
+struct log_field;
 enum class level;
 
 namespace sinks {
@@ -0,0 +1,74 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "./common.h"
+
+// Max number of key/value fields a single log message can carry.
+// Fields are stored inline (no heap allocation) by the logger and by log_msg_buffer.
+#ifndef SPDLOG_MAX_LOG_FIELDS
+    #define SPDLOG_MAX_LOG_FIELDS 8
+#endif
+
+namespace spdlog {
+
+//
+// Typed key/value field attached to a log message without string formatting.
+// e.g: logger->info("order filled", spdlog::kv("id", id), spdlog::kv("px", px));
+//
+// The key and string values are views. They only need to outlive the log call itself
+// since log_msg_buffer (used by async loggers and the ringbuffer sink) deep-copies them.
+//
+struct log_field {
+    enum class value_type : std::uint8_t { boolean, int64, uint64, float64, string };
+
+    string_view_t key;
+    value_type type{value_type::string};
+    union {
+        bool bool_value;
+        std::int64_t int_value;
+        std::uint64_t uint_value;
+        double double_value;
+        struct {
+            const char *data;
+            size_t size;
+        } str_value;
+    } value{};
+
+    [[nodiscard]] string_view_t string_value() const noexcept {
+        return type == value_type::string ? string_view_t{value.str_value.data, value.str_value.size} : string_view_t{};
+    }
+};
+
+// Create a log_field from the given key and value.
+// Supported value types: bool, integral, floating point and anything convertible to string_view_t.
+template <typename T>
+[[nodiscard]] log_field kv(string_view_t key, const T &value) noexcept {
+    log_field field;
+    field.key = key;
+    if constexpr (std::is_same_v<T, bool>) {
+        field.type = log_field::value_type::boolean;
+        field.value.bool_value = value;
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        field.type = log_field::value_type::int64;
+        field.value.int_value = static_cast<std::int64_t>(value);
+    } else if constexpr (std::is_integral_v<T>) {
+        field.type = log_field::value_type::uint64;
+        field.value.uint_value = static_cast<std::uint64_t>(value);
+    } else if constexpr (std::is_floating_point_v<T>) {
+        field.type = log_field::value_type::float64;
+        field.value.double_value = static_cast<double>(value);
+    } else {
+        static_assert(std::is_convertible_v<const T &, string_view_t>, "spdlog::kv(): unsupported value type");
+        const string_view_t sv = value;
+        field.type = log_field::value_type::string;
+        field.value.str_value = {sv.data(), sv.size()};
+    }
+    return field;
+}
+
+}  // namespace spdlog
@@ -6,7 +6,8 @@
 // Thread safe logger (except for set_error_handler())
 // Has name, log level, vector of std::shared sink pointers and formatter
 // Upon each log write the logger:
-// 1. Checks if its log level is enough to log the message and if yes:
+// 1. Checks if its log level, and the level of at least one of its sinks, is enough to log the message
+//    (see should_log()) and if yes:
 // 2. Call the underlying sinks to do the job.
 // 3. Each sink use its own private copy of a formatter to format the message
 // and send to its destination.
@@ -14,12 +15,15 @@
 // The use of private formatter per sink provides the opportunity to cache some
 // formatted data, and support for different format per sink.
 
+#include <array>
 #include <cassert>
 #include <iterator>
 #include <vector>
 
 #include "./common.h"
+#include "./details/format_buffer.h"
 #include "./details/log_msg.h"
+#include "./log_field.h"
 #include "./sinks/sink.h"
 
 #define SPDLOG_LOGGER_CATCH(location)                                                                                     \
@@ -95,6 +99,55 @@ public:
         }
     }
 
+    // log string message with structured key/value fields
+    // e.g: logger->info("order filled", spdlog::kv("id", id), spdlog::kv("px", px));
+    template <typename... Fields, std::enable_if_t<details::is_log_fields_v<Fields...>, int> = 0>
+    void log(source_loc loc, level lvl, string_view_t msg, const Fields &...fields) {
+        if (should_log(lvl)) {
+            log_with_fields_(loc, lvl, msg, fields...);
+        }
+    }
+
+    template <typename... Fields, std::enable_if_t<details::is_log_fields_v<Fields...>, int> = 0>
+    void log(level lvl, string_view_t msg, const Fields &...fields) {
+        if (should_log(lvl)) {
+            log_with_fields_(source_loc{}, lvl, msg, fields...);
+        }
+    }
+
+    // log regardless of the logger's level (the sinks levels still apply).
+    // used by the call sites enabled at runtime (see call_site.h).
+    template <typename... Args>
+    void force_log(source_loc loc, level lvl, format_string_t<Args...> fmt, Args &&...args) {
+        log_with_format_(loc, lvl, fmt, std::forward<Args>(args)...);
+    }
+
+    void force_log(source_loc loc, level lvl, string_view_t msg) { sink_it_(details::log_msg(loc, name_, lvl, msg)); }
+
+    template <typename... Fields, std::enable_if_t<details::is_log_fields_v<Fields...>, int> = 0>
+    void force_log(source_loc loc, level lvl, string_view_t msg, const Fields &...fields) {
+        log_with_fields_(loc, lvl, msg, fields...);
+    }
+
+    // log the string returned by the given callable, which is called only if the level is enabled.
+    // e.g: logger->log_lazy(spdlog::level::debug, [&] { return dump_state(); });
+    // the callable returns anything convertible to string_view_t (e.g. std::string, const char*).
+    template <typename F>
+    void log_lazy(source_loc loc, level lvl, F &&msg_fn) {
+        if (should_log(lvl)) {
+            try {
+                const auto &msg = std::forward<F>(msg_fn)();
+                sink_it_(details::log_msg(loc, name_, lvl, string_view_t(msg)));
+            }
+            SPDLOG_LOGGER_CATCH(loc)
+        }
+    }
+
+    template <typename F>
+    void log_lazy(level lvl, F &&msg_fn) {
+        log_lazy(source_loc{}, lvl, std::forward<F>(msg_fn));
+    }
+
     template <typename... Args>
     void trace(format_string_t<Args...> fmt, Args &&...args) {
         log(level::trace, fmt, std::forward<Args>(args)...);
@@ -133,8 +186,40 @@ public:
     void error(string_view_t msg) { log(level::err, msg); }
     void critical(string_view_t msg) { log(level::critical, msg); }
 
-    // return true if logging is enabled for the given level.
-    [[nodiscard]] bool should_log(level msg_level) const { return msg_level >= level_.load(std::memory_order_relaxed); }
+    // log functions with string message and key/value fields
+    template <typename... Fields, std::enable_if_t<details::is_log_fields_v<Fields...>, int> = 0>
+    void trace(string_view_t msg, const Fields &...fields) {
+        log(level::trace, msg, fields...);
+    }
+
+    template <typename... Fields, std::enable_if_t<details::is_log_fields_v<Fields...>, int> = 0>
+    void debug(string_view_t msg, const Fields &...fields) {
+        log(level::debug, msg, fields...);
+    }
+
+    template <typename... Fields, std::enable_if_t<details::is_log_fields_v<Fields...>, int> = 0>
+    void info(string_view_t msg, const Fields &...fields) {
+        log(level::info, msg, fields...);
+    }
+
+    template <typename... Fields, std::enable_if_t<details::is_log_fields_v<Fields...>, int> = 0>
+    void warn(string_view_t msg, const Fields &...fields) {
+        log(level::warn, msg, fields...);
+    }
+
+    template <typename... Fields, std::enable_if_t<details::is_log_fields_v<Fields...>, int> = 0>
+    void error(string_view_t msg, const Fields &...fields) {
+        log(level::err, msg, fields...);
+    }
+
+    template <typename... Fields, std::enable_if_t<details::is_log_fields_v<Fields...>, int> = 0>
+    void critical(string_view_t msg, const Fields &...fields) {
+        log(level::critical, msg, fields...);
+    }
+
+    // return true if logging is enabled for the given level: the message passes the logger's level and the
+    // level of at least one sink - so messages no sink would accept are rejected before formatting.
+    [[nodiscard]] bool should_log(level msg_level) const { return msg_level >= effective_level(); }
 
     // set the level of logging
     void set_level(level level);
@@ -142,6 +227,18 @@ public:
     // return the active log level
     [[nodiscard]] level log_level() const;
 
+    // return the lowest level that is logged: the max of the logger's level and the min of its sinks levels
+    // (off if it has no sinks). cached, and recomputed after the level of the logger or of any sink changes,
+    // or after add_sink()/remove_sink(). once the mutable sinks() was called, the sinks levels are not
+    // considered anymore (they may change behind the logger's back) and this is the logger's level.
+    [[nodiscard]] level effective_level() const {
+        const auto cached = effective_level_.load(std::memory_order_relaxed);
+        if ((cached >> 8) != sinks::sink::levels_version()) {
+            return update_effective_level_();
+        }
+        return static_cast<level>(cached & 0xff);
+    }
+
     // return the name of the logger
     [[nodiscard]] const std::string &name() const;
 
@@ -162,8 +259,13 @@ public:
 
     // sinks
     [[nodiscard]] const std::vector<sink_ptr> &sinks() const;
+    // note: stops the filtering by the sinks levels in should_log() - prefer add_sink()/remove_sink().
     [[nodiscard]] std::vector<sink_ptr> &sinks();
 
+    // not thread safe - like modifying sinks(), don't call while logging from other threads.
+    void add_sink(sink_ptr sink);
+    void remove_sink(const sink_ptr &sink);
+
     // error handler
     void set_error_handler(err_handler);
 
@@ -176,23 +278,39 @@ protected:
     spdlog::atomic_level_t level_{level::info};
     spdlog::atomic_level_t flush_level_{level::off};
     err_handler custom_err_handler_{nullptr};
+    // effective level (low 8 bits) and the sink::levels_version() it was computed at. starts invalid.
+    mutable std::atomic<uint64_t> effective_level_{UINT64_MAX};
+    // the mutable sinks() was called: the sinks levels are not cached
+    std::atomic<bool> sinks_exposed_{false};
+
+    level update_effective_level_() const;
 
     // common implementation for after templated public api has been resolved to format string and
     // args
     template <typename... Args>
     void log_with_format_(source_loc loc, const level lvl, const format_string_t<Args...> &format_string, Args &&...args) {
-        assert(should_log(lvl));
         try {
-            memory_buf_t buf;
+            details::format_buffer format_buf;
+            memory_buf_t &buf = format_buf.get();
             fmt::vformat_to(std::back_inserter(buf), format_string, fmt::make_format_args(args...));
             sink_it_(details::log_msg(loc, name_, lvl, string_view_t(buf.data(), buf.size())));
         }
         SPDLOG_LOGGER_CATCH(loc)
     }
 
+    // the fields are kept in an inline array on the stack - no allocation.
+    template <typename... Fields>
+    void log_with_fields_(source_loc loc, const level lvl, string_view_t msg, const Fields &...fields) {
+        static_assert(sizeof...(Fields) <= SPDLOG_MAX_LOG_FIELDS, "Too many key/value fields (see SPDLOG_MAX_LOG_FIELDS)");
+        const std::array<log_field, sizeof...(Fields)> fields_arr{fields...};
+        details::log_msg log_msg(loc, name_, lvl, msg);
+        log_msg.fields = fields_arr.data();
+        log_msg.fields_count = fields_arr.size();
+        sink_it_(log_msg);
+    }
+
     // log the given message (if the given log level is high enough)
     virtual void sink_it_(const details::log_msg &msg) {
-        assert(should_log(msg.log_level));
         for (auto &sink : sinks_) {
             if (sink->should_log(msg.log_level)) {
                 try {
@@ -0,0 +1,85 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+// Mapped diagnostic context (MDC) - thread local key/value pairs attached to every log message
+// logged from the current thread (e.g. request id, tenant).
+// The context is rendered by the '%&' pattern flag as "key1=value1 key2=value2".
+//
+// Usage:
+//
+// {
+//     spdlog::mdc_guard request_guard("request_id", request_id);
+//     spdlog::info("handling request");  // => ... request_id=1234
+// }  // request_id is removed from the context here.
+//
+// Each change creates a new immutable, reference counted context block. Log messages only
+// take a pointer to the current block, so logging never allocates or copies the context.
+// Async loggers keep the block alive (by reference count) until the message is processed.
+//
+// Note: not available if compiled with SPDLOG_NO_TLS (all functions are no-op).
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "./common.h"
+
+namespace spdlog {
+namespace details {
+
+// immutable snapshot of the thread's context
+class SPDLOG_API mdc_data : public std::enable_shared_from_this<mdc_data> {
+public:
+    using entry_type = std::pair<std::string, std::string>;
+
+    explicit mdc_data(std::vector<entry_type> entries)
+        : entries_(std::move(entries)) {}
+
+    [[nodiscard]] const std::vector<entry_type> &entries() const noexcept { return entries_; }
+
+private:
+    std::vector<entry_type> entries_;
+};
+
+}  // namespace details
+
+class SPDLOG_API mdc {
+public:
+    // add or replace the given key in the current thread's context
+    static void put(const std::string &key, const std::string &value);
+
+    // remove the given key from the current thread's context
+    static void remove(const std::string &key);
+
+    // remove all keys from the current thread's context
+    static void clear();
+
+    // return the value of the given key or empty string if not found
+    [[nodiscard]] static std::string get(const std::string &key);
+
+    // return the current thread's context block (nullptr if empty)
+    [[nodiscard]] static const details::mdc_data *current() noexcept;
+
+private:
+    friend class mdc_guard;
+    static std::shared_ptr<const details::mdc_data> &current_ref_();
+};
+
+// RAII guard - put key=value on construction and restore the previous context on destruction.
+// Guards must be destroyed in reverse order of construction (i.e. scoped on the stack).
+class SPDLOG_API mdc_guard {
+public:
+    mdc_guard(const std::string &key, const std::string &value);
+    ~mdc_guard();
+
+    mdc_guard(const mdc_guard &) = delete;
+    mdc_guard &operator=(const mdc_guard &) = delete;
+
+private:
+    std::shared_ptr<const details::mdc_data> prev_;
+};
+
+}  // namespace spdlog
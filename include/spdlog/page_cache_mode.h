@@ -0,0 +1,25 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+namespace spdlog {
+//
+// How file sinks use the os page cache. Heavy logging fills the cache with data that is rarely read back,
+// evicting the data of the application.
+//
+// page_cache_mode::keep - regular writes (the default).
+// page_cache_mode::drop - regular writes, then the written data is dropped from the cache once it is on the
+//      disk: every 1MB written, the writeback of the new data is started (sync_file_range on linux) and the
+//      data written back since the previous time is dropped (posix_fadvise(POSIX_FADV_DONTNEED)).
+//      No effect where not supported.
+// page_cache_mode::bypass - direct I/O (O_DIRECT), which doesn't go through the cache at all. The messages
+//      are collected in two block aligned buffers: when one is full, a background thread writes it while
+//      the other one is filled. flush() writes the last partial block padded with zeros and truncates the
+//      file back to its size. Falls back to page_cache_mode::drop if the file system doesn't support direct
+//      I/O. Can't be combined with compression_mode::live, and preallocated files are written normally.
+//
+// e.g. file_sink->set_page_cache_mode(spdlog::page_cache_mode::drop);
+//
+enum class page_cache_mode { keep, drop, bypass };
+}  // namespace spdlog
@@ -4,9 +4,12 @@
 #pragma once
 
 #include <array>
+#include <chrono>
+#include <memory>
 #include <mutex>
 #include <string>
 
+#include "../details/console_flusher.h"
 #include "../details/null_mutex.h"
 #include "./base_sink.h"
 
@@ -18,6 +21,11 @@ namespace sinks {
  * depending on the severity
  * of the message.
  * If no color terminal detected, omit the escape codes.
+ *
+ * Each message is written with a single fwrite, the escape codes spliced into the formatted text.
+ * Like stdout_sink_base, messages are flushed one by one only when writing to a terminal. Otherwise they
+ * are written in batches by the stdio buffer, flushed at least every flush_interval (see
+ * details/console_flusher.h).
  */
 
 template <typename Mutex>
@@ -28,12 +36,17 @@ public:
     ansicolor_sink(ansicolor_sink &&other) = delete;
     ansicolor_sink &operator=(const ansicolor_sink &other) = delete;
     ansicolor_sink &operator=(ansicolor_sink &&other) = delete;
-    ~ansicolor_sink() override = default;
+    ~ansicolor_sink() override;
 
     void set_color(level color_level, string_view_t color);
     void set_color_mode(color_mode mode);
     bool should_color() const;
 
+    // max time messages may wait in the stdio buffer when not writing to a terminal (0 - flush every message)
+    void set_flush_interval(std::chrono::milliseconds interval);
+    // true if every message is flushed (writing to a terminal, or flush interval 0)
+    bool line_flush();
+
     // Formatting codes
     static constexpr std::string_view reset = "\033[m";
     static constexpr std::string_view bold = "\033[1m";
@@ -75,8 +88,11 @@ private:
     FILE *target_file_;
     bool should_do_colors_;
     std::array<std::string, levels_count> colors_;
-    void print_ccode_(const string_view_t color_code);
-    void print_range_(const memory_buf_t &formatted, size_t start, size_t end);
+    // reused across messages: the formatted message, and the same with the escape codes
+    memory_buf_t formatted_;
+    memory_buf_t colored_;
+    details::console_flusher flusher_;
+
     static std::string to_string_(const string_view_t sv);
 };
 
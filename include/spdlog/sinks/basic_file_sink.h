@@ -14,13 +14,22 @@
 namespace spdlog {
 namespace sinks {
 /*
- * Trivial file sink with single file as target
+ * Trivial file sink with single file as target.
+ * If write_buffer_size > 0, messages are buffered by the sink and written with writev() when the
+ * buffer is full or on flush, instead of going through stdio (see details::file_helper).
  */
 template <typename Mutex>
 class basic_file_sink final : public base_sink<Mutex> {
 public:
-    explicit basic_file_sink(const filename_t &filename, bool truncate = false, const file_event_handlers &event_handlers = {});
+    explicit basic_file_sink(const filename_t &filename,
+                             bool truncate = false,
+                             const file_event_handlers &event_handlers = {},
+                             size_t write_buffer_size = 0);
     const filename_t &filename() const;
+    // fsync the written data according to the given policy (see file_sync_policy.h)
+    void set_sync_policy(const file_sync_policy &policy);
+    // limit the page cache used by the written data (see page_cache_mode.h)
+    void set_page_cache_mode(page_cache_mode mode);
 
 protected:
     void sink_it_(const details::log_msg &msg) override;
@@ -28,6 +37,7 @@ protected:
 
 private:
     details::file_helper file_helper_;
+    memory_buf_t formatted_;  // reused (under the sink's mutex) so large messages don't allocate every time
 };
 
 using basic_file_sink_mt = basic_file_sink<std::mutex>;
@@ -42,16 +52,18 @@ template <typename Factory = spdlog::synchronous_factory>
 std::shared_ptr<logger> basic_logger_mt(const std::string &logger_name,
                                         const filename_t &filename,
                                         bool truncate = false,
-                                        const file_event_handlers &event_handlers = {}) {
-    return Factory::template create<sinks::basic_file_sink_mt>(logger_name, filename, truncate, event_handlers);
+                                        const file_event_handlers &event_handlers = {},
+                                        size_t write_buffer_size = 0) {
+    return Factory::template create<sinks::basic_file_sink_mt>(logger_name, filename, truncate, event_handlers, write_buffer_size);
 }
 
 template <typename Factory = spdlog::synchronous_factory>
 std::shared_ptr<logger> basic_logger_st(const std::string &logger_name,
                                         const filename_t &filename,
                                         bool truncate = false,
-                                        const file_event_handlers &event_handlers = {}) {
-    return Factory::template create<sinks::basic_file_sink_st>(logger_name, filename, truncate, event_handlers);
+                                        const file_event_handlers &event_handlers = {},
+                                        size_t write_buffer_size = 0) {
+    return Factory::template create<sinks::basic_file_sink_st>(logger_name, filename, truncate, event_handlers, write_buffer_size);
 }
 
 }  // namespace spdlog
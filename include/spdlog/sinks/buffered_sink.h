@@ -0,0 +1,82 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "../details/null_mutex.h"
+#include "../details/periodic_worker.h"
+#include "./base_sink.h"
+
+namespace spdlog {
+namespace sinks {
+
+struct buffered_sink_config {
+    size_t max_bytes = 64 * 1024;                    // write when this many formatted bytes are buffered
+    std::chrono::milliseconds flush_interval{1000};  // write what's buffered for longer than this (0 - never)
+    level flush_level = level::err;                  // write and flush the inner sink on messages of this level
+};
+
+//
+// Buffering sink. Formats the messages with its own formatter into a buffer, and hands the inner sink the
+// whole buffer as the payload of a single message: one write instead of one per message.
+//
+// The buffer is written when it reaches max_bytes, when its oldest message is older than flush_interval,
+// and on messages of flush_level or above (which also flush the inner sink). flush() writes the buffer
+// and flushes the inner sink, and so does the destructor.
+// The _mt version also checks flush_interval every flush_interval from a timer thread, so quiet periods
+// don't keep messages in the buffer for more than twice flush_interval; what the timer writes is flushed
+// too. The _st version checks it only when a message is logged. Errors of the timer thread are rethrown
+// by the next log() or flush().
+//
+// The inner sink's formatter is replaced by one that writes the payload as is ("%v", no eol), so its
+// pattern is set on the buffered_sink instead. Its level should be left at trace - set the level of the
+// buffered_sink instead. The inner sink must not be used by another logger.
+// Not for datagram sinks (udp_sink): a batch would be sent as one datagram, larger than the datagram size
+// limit with the default max_bytes, and receivers expect one message per datagram.
+//
+// e.g. auto sink = std::make_shared<spdlog::sinks::buffered_sink_mt>(std::make_shared<tcp_sink_mt>(cfg));
+//
+template <typename Mutex>
+class buffered_sink final : public base_sink<Mutex> {
+public:
+    explicit buffered_sink(std::shared_ptr<sink> inner, buffered_sink_config config = {});
+    ~buffered_sink() override;
+
+    buffered_sink(const buffered_sink &) = delete;
+    buffered_sink &operator=(const buffered_sink &) = delete;
+
+    const std::shared_ptr<sink> &inner() const noexcept { return inner_; }
+
+    // bytes waiting in the buffer
+    size_t buffered_bytes();
+
+protected:
+    void sink_it_(const details::log_msg &msg) override;
+    void flush_() override;
+
+private:
+    // hand the buffer to the inner sink
+    void write_buffer_();
+    // called by the timer thread
+    void on_timer_();
+    void check_error_();
+
+    std::shared_ptr<sink> inner_;
+    buffered_sink_config config_;
+    memory_buf_t buffer_;
+    level buffer_level_ = level::trace;  // highest level of the buffered messages
+    log_clock::time_point buffer_time_;  // time of the oldest buffered message
+    std::string timer_error_;
+    std::unique_ptr<details::periodic_worker> timer_;
+};
+
+using buffered_sink_mt = buffered_sink<std::mutex>;
+using buffered_sink_st = buffered_sink<details::null_mutex>;
+
+}  // namespace sinks
+}  // namespace spdlog
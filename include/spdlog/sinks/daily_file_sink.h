@@ -4,19 +4,21 @@
 #pragma once
 
 #include <chrono>
-#include <cstdio>
+#include <ctime>
+#include <cwchar>
 #include <iomanip>
+#include <iterator>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
 
 #include "../common.h"
-#include "../details/circular_q.h"
-#include "../details/file_helper.h"
 #include "../details/null_mutex.h"
-#include "../details/os.h"
 #include "../details/synchronous_factory.h"
-#include "./base_sink.h"
+#include "../details/time_rotation.h"
+#include "../fmt/fmt.h"
+#include "./time_file_sink.h"
 
 namespace spdlog {
 namespace sinks {
@@ -26,12 +28,10 @@ namespace sinks {
  */
 struct daily_filename_calculator {
     static filename_t calc_filename(const filename_t &filename, const tm &now_tm) {
-        filename_t basename, ext;
-        std::tie(basename, ext) = details::os::split_by_extension(filename);
-        std::basic_ostringstream<filename_t::value_type> oss;
-        oss << basename.native() << '_' << std::setfill(SPDLOG_FILENAME_T('0')) << std::setw(4) << now_tm.tm_year + 1900 << '-'
-            << std::setw(2) << now_tm.tm_mon + 1 << '-' << std::setw(2) << now_tm.tm_mday << ext.native();
-        return oss.str();
+        fmt_lib::basic_memory_buffer<char, 32> suffix;
+        fmt_lib::format_to(std::back_inserter(suffix), "_{:04d}-{:02d}-{:02d}", now_tm.tm_year + 1900, now_tm.tm_mon + 1,
+                           now_tm.tm_mday);
+        return details::insert_before_extension(filename, string_view_t{suffix.data(), suffix.size()});
     }
 };
 
@@ -46,22 +46,33 @@ struct daily_filename_calculator {
  */
 struct daily_filename_format_calculator {
     static filename_t calc_filename(const filename_t &file_path, const tm &now_tm) {
+        // strftime to a stack buffer. 0 means it didn't fit (or the result is empty) - fall back to put_time.
+        filename_t::value_type buf[256];
+        const size_t n = strftime_(buf, std::size(buf), file_path.c_str(), now_tm);
+        if (n > 0) {
+            return filename_t::string_type(buf, n);
+        }
         std::basic_ostringstream<filename_t::value_type> stream;
         stream << std::put_time(&now_tm, file_path.c_str());
         return stream.str();
     }
+
+private:
+    static size_t strftime_(char *buf, size_t size, const char *format, const tm &now_tm) {
+        return std::strftime(buf, size, format, &now_tm);
+    }
+    static size_t strftime_(wchar_t *buf, size_t size, const wchar_t *format, const tm &now_tm) {
+        return std::wcsftime(buf, size, format, &now_tm);
+    }
 };
 
 /*
- * Rotating file sink based on date.
+ * Rotating file sink based on date - a new file every day at the given time (see time_file_sink.h).
  * If truncate != false , the created file will be truncated.
- * If max_files > 0, retain only the last max_files and delete previous.
- * If max_files > 0, retain only the last max_files and delete previous.
- * Note that old log files from previous executions will not be deleted by this class,
- * rotation and deletion is only applied while the program is running.
+ * If max_files > 0, retain only the last max_files (including those of previous executions) and delete previous.
  */
 template <typename Mutex, typename FileNameCalc = daily_filename_calculator>
-class daily_file_sink final : public base_sink<Mutex> {
+class daily_file_sink final : public time_file_sink<Mutex, FileNameCalc> {
 public:
     // create daily file sink which rotates on given time
     daily_file_sink(filename_t base_filename,
@@ -70,118 +81,17 @@ public:
                     bool truncate = false,
                     uint16_t max_files = 0,
                     const file_event_handlers &event_handlers = {})
-        : base_filename_(std::move(base_filename)),
-          rotation_h_(rotation_hour),
-          rotation_m_(rotation_minute),
-          file_helper_{event_handlers},
-          truncate_(truncate),
-          max_files_(max_files),
-          filenames_q_() {
-        if (rotation_hour < 0 || rotation_hour > 23 || rotation_minute < 0 || rotation_minute > 59) {
-            throw_spdlog_ex("daily_file_sink: Invalid rotation time in ctor");
-        }
-
-        auto now = log_clock::now();
-        auto filename = FileNameCalc::calc_filename(base_filename_, now_tm(now));
-        file_helper_.open(filename, truncate_);
-        rotation_tp_ = next_rotation_tp_();
-
-        if (max_files_ > 0) {
-            init_filenames_q_();
-        }
-    }
-
-    filename_t filename() {
-        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
-        return file_helper_.filename();
-    }
-
-protected:
-    void sink_it_(const details::log_msg &msg) override {
-        auto time = msg.time;
-        bool should_rotate = time >= rotation_tp_;
-        if (should_rotate) {
-            auto filename = FileNameCalc::calc_filename(base_filename_, now_tm(time));
-            file_helper_.open(filename, truncate_);
-            rotation_tp_ = next_rotation_tp_();
-        }
-        memory_buf_t formatted;
-        base_sink<Mutex>::formatter_->format(msg, formatted);
-        file_helper_.write(formatted);
-
-        // Do the cleaning only at the end because it might throw on failure.
-        if (should_rotate && max_files_ > 0) {
-            delete_old_();
-        }
-    }
-
-    void flush_() override { file_helper_.flush(); }
+        : time_file_sink<Mutex, FileNameCalc>(
+              std::move(base_filename), daily_rotation_(rotation_hour, rotation_minute), truncate, max_files, event_handlers) {}
 
 private:
-    void init_filenames_q_() {
-        using details::os::path_exists;
-
-        filenames_q_ = details::circular_q<filename_t>(static_cast<size_t>(max_files_));
-        std::vector<filename_t> filenames;
-        auto now = log_clock::now();
-        while (filenames.size() < max_files_) {
-            auto filename = FileNameCalc::calc_filename(base_filename_, now_tm(now));
-            if (!path_exists(filename)) {
-                break;
-            }
-            filenames.emplace_back(filename);
-            now -= std::chrono::hours(24);
-        }
-        for (auto iter = filenames.rbegin(); iter != filenames.rend(); ++iter) {
-            filenames_q_.push_back(std::move(*iter));
-        }
-    }
-
-    tm now_tm(log_clock::time_point tp) {
-        time_t tnow = log_clock::to_time_t(tp);
-        return spdlog::details::os::localtime(tnow);
-    }
-
-    log_clock::time_point next_rotation_tp_() {
-        auto now = log_clock::now();
-        tm date = now_tm(now);
-        date.tm_hour = rotation_h_;
-        date.tm_min = rotation_m_;
-        date.tm_sec = 0;
-        auto rotation_time = log_clock::from_time_t(std::mktime(&date));
-        if (rotation_time > now) {
-            return rotation_time;
-        }
-        return {rotation_time + std::chrono::hours(24)};
-    }
-
-    // Delete the file N rotations ago.
-    // Throw spdlog_ex on failure to delete the old file.
-    void delete_old_() {
-        using details::os::filename_to_str;
-        using details::os::remove_if_exists;
-
-        filename_t current_file = file_helper_.filename();
-        if (filenames_q_.full()) {
-            auto old_filename = std::move(filenames_q_.front());
-            filenames_q_.pop_front();
-            bool ok = remove_if_exists(old_filename);
-            if (!ok) {
-                filenames_q_.push_back(std::move(current_file));
-                throw_spdlog_ex("Failed removing daily file " + filename_to_str(old_filename), errno);
-            }
+    static details::time_rotation daily_rotation_(int rotation_hour, int rotation_minute) {
+        if (rotation_hour < 0 || rotation_hour > 23 || rotation_minute < 0 || rotation_minute > 59) {
+            throw_spdlog_ex("daily_file_sink: Invalid rotation time in ctor");
         }
-        filenames_q_.push_back(std::move(current_file));
+        return details::time_rotation{std::chrono::hours(24),
+                                      std::chrono::hours(rotation_hour) + std::chrono::minutes(rotation_minute)};
     }
-
-    filename_t base_filename_;
-    int rotation_h_;
-    int rotation_m_;
-    log_clock::time_point rotation_tp_;
-    details::file_helper file_helper_;
-    bool truncate_;
-    uint16_t max_files_;
-    details::circular_q<filename_t> filenames_q_;
 };
 
 using daily_file_sink_mt = daily_file_sink<std::mutex>;
@@ -0,0 +1,99 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../async_logger.h"
+#include "../details/log_msg_buffer.h"
+#include "../details/null_mutex.h"
+#include "../details/spsc_queue.h"
+#include "./base_sink.h"
+
+namespace spdlog {
+
+// Counters of one child of a fanout_sink
+struct fanout_stats {
+    size_t pending = 0;  // messages queued but not written yet (the lag of the child)
+    size_t written = 0;
+    size_t dropped = 0;  // messages discarded because the queue was full (async_overflow_policy::discard_new)
+    size_t failed = 0;   // messages (or flushes) the child sink threw on
+};
+
+namespace sinks {
+//
+// Parallel distribution sink. Like dist_sink, but each child sink is written by its own thread, fed by
+// its own single producer-single consumer queue of queue_size messages. Logging copies the message once
+// into the queue of each child (whose level allows it), so a slow child (e.g. a file on a slow disk or
+// NFS mount) delays only its own queue.
+//
+// When a child's queue is full, async_overflow_policy::discard_new (the default) drops the message for
+// that child and counts it, async_overflow_policy::block waits for room. overrun_oldest is not supported.
+// flush() queues a flush for each child and returns without waiting for it - use wait_idle() to wait
+// until everything queued so far was written.
+// The child sinks are called from their writer thread and from the thread that calls set_pattern() or
+// set_formatter() - use thread safe (_mt) child sinks.
+//
+template <typename Mutex>
+class fanout_sink final : public base_sink<Mutex> {
+public:
+    explicit fanout_sink(std::vector<std::shared_ptr<sink>> sinks,
+                         size_t queue_size = 8192,
+                         async_overflow_policy overflow_policy = async_overflow_policy::discard_new);
+    ~fanout_sink() override;
+
+    fanout_sink(const fanout_sink &) = delete;
+    fanout_sink &operator=(const fanout_sink &) = delete;
+
+    const std::vector<std::shared_ptr<sink>> &sinks() const noexcept { return sinks_; }
+
+    // counters of each child sink, in the order of sinks()
+    std::vector<fanout_stats> stats() const;
+
+    // wait until the writer threads wrote everything queued so far
+    void wait_idle();
+
+protected:
+    void sink_it_(const details::log_msg &msg) override;
+    void flush_() override;
+    void set_pattern_(const std::string &pattern) override;
+    void set_formatter_(std::unique_ptr<spdlog::formatter> sink_formatter) override;
+
+private:
+    enum class item_type { log, flush, terminate };
+
+    struct item {
+        item_type type = item_type::log;
+        details::log_msg_buffer msg;
+    };
+
+    struct child {
+        child(std::shared_ptr<sink> child_sink, size_t queue_size);
+
+        std::shared_ptr<sink> sink_ptr;
+        details::spsc_queue<item> queue;
+        std::atomic<size_t> written{0};
+        std::atomic<size_t> dropped{0};
+        std::atomic<size_t> failed{0};
+        std::thread thread;
+    };
+
+    // queue an item of the given type for the child. return false if dropped.
+    bool enqueue_(child &c, item_type type, const details::log_msg *msg);
+    static void writer_loop_(child &c);
+
+    std::vector<std::shared_ptr<sink>> sinks_;
+    async_overflow_policy overflow_policy_;
+    std::vector<std::unique_ptr<child>> children_;
+};
+
+using fanout_sink_mt = fanout_sink<std::mutex>;
+using fanout_sink_st = fanout_sink<details::null_mutex>;
+
+}  // namespace sinks
+}  // namespace spdlog
@@ -0,0 +1,107 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifdef _WIN32
+    #error "mmap_file_sink is not available on windows"
+#endif
+
+#include <mutex>
+#include <string>
+
+#include "../details/file_helper.h"
+#include "../details/null_mutex.h"
+#include "../details/synchronous_factory.h"
+#include "./base_sink.h"
+
+namespace spdlog {
+namespace sinks {
+/*
+ * Memory mapped file sink with rotating_file_sink style size based rotation.
+ *
+ * The file is extended (fallocate on linux) and mapped in windows of map_size bytes. Logging a message
+ * is a memcpy to the mapping - no syscall unless the window is full, in which case the next window is
+ * mapped. Since the data is in the page cache as soon as it is copied, it survives a crash of the
+ * process (but not of the machine, unless sync() was called).
+ * If the disk is full, extending the file fails and the message is not logged (spdlog_ex). Where fallocate
+ * isn't available (other systems, or file systems not supporting it), the file is extended with ftruncate
+ * without allocating its blocks: writing to the mapping on a full disk then raises SIGBUS, which kills the
+ * process.
+ * flush() starts writing back the dirty pages (msync MS_ASYNC), sync() waits for it (msync MS_SYNC).
+ *
+ * When the file is closed (rotation or destruction), it is truncated to the written size. A file left
+ * by a crashed process may end with zero bytes up to the end of the last window.
+ * The file event handlers are called as in rotating_file_sink. The after_open handler's output
+ * precedes the mapped data and the before_close handler's output is appended after the truncation.
+ */
+template <typename Mutex>
+class mmap_file_sink final : public base_sink<Mutex> {
+public:
+    static constexpr size_t default_map_size = 1024 * 1024;
+
+    mmap_file_sink(filename_t base_filename,
+                   std::size_t max_size,
+                   std::size_t max_files,
+                   const file_event_handlers &event_handlers = {},
+                   std::size_t map_size = default_map_size);
+    ~mmap_file_sink() override;
+
+    filename_t filename();
+    void rotate_now();
+    // wait until the written data reaches the disk
+    void sync();
+
+protected:
+    void sink_it_(const details::log_msg &msg) override;
+    void flush_() override;
+
+private:
+    void open_(bool truncate);
+    void close_();
+    void map_at_(std::size_t offset);
+    void unmap_();
+    void write_(const char *data, std::size_t size);
+    // Rotate files like rotating_file_sink: log.txt -> log.1.txt -> log.2.txt .. -> delete
+    void rotate_();
+
+    filename_t base_filename_;
+    std::size_t max_size_;
+    std::size_t max_files_;
+    std::size_t map_size_;
+    details::file_helper file_helper_;
+    int fd_ = -1;
+    char *map_ = nullptr;
+    std::size_t map_offset_ = 0;  // file offset of the mapped window
+    std::size_t reserved_ = 0;    // file size reserved so far (>= size_)
+    std::size_t size_ = 0;        // bytes written to the file
+    memory_buf_t formatted_;
+};
+
+using mmap_file_sink_mt = mmap_file_sink<std::mutex>;
+using mmap_file_sink_st = mmap_file_sink<details::null_mutex>;
+
+}  // namespace sinks
+
+//
+// factory functions
+//
+template <typename Factory = spdlog::synchronous_factory>
+std::shared_ptr<logger> mmap_logger_mt(const std::string &logger_name,
+                                       const filename_t &filename,
+                                       size_t max_file_size,
+                                       size_t max_files,
+                                       const file_event_handlers &event_handlers = {}) {
+    return Factory::template create<sinks::mmap_file_sink_mt>(logger_name, filename, max_file_size, max_files, event_handlers);
+}
+
+template <typename Factory = spdlog::synchronous_factory>
+std::shared_ptr<logger> mmap_logger_st(const std::string &logger_name,
+                                       const filename_t &filename,
+                                       size_t max_file_size,
+                                       size_t max_files,
+                                       const file_event_handlers &event_handlers = {}) {
+    return Factory::template create<sinks::mmap_file_sink_st>(logger_name, filename, max_file_size, max_files, event_handlers);
+}
+
+}  // namespace spdlog
@@ -9,6 +9,7 @@
 
 #include "../details/circular_q.h"
 #include "../details/log_msg_buffer.h"
+#include "../details/log_msg_ring.h"
 #include "../details/null_mutex.h"
 #include "./base_sink.h"
 
@@ -19,6 +20,12 @@ namespace sinks {
  * messages override the old ones. Useful for storing debug data in memory in case of error.
  * Example: auto rb_sink = std::make_shared<spdlog::sinks::ringbuffer_sink_mt>(128); spdlog::logger
  * logger("rb_logger", rb_sink); rb->drain([](const std::string_view msg) { process(msg);});
+ *
+ * Given an arena size too, the messages are stored in one byte arena allocated on construction instead
+ * (see details/log_msg_ring.h), so logging to this sink never allocates. The ring then keeps at most
+ * n_items messages, fewer if they don't fit in the arena, and drops messages larger than the arena.
+ * e.g. a 64MB ring limited by size only:
+ * ringbuffer_sink_mt(std::numeric_limits<size_t>::max(), 64 * 1024 * 1024);
  */
 template <typename Mutex>
 class ringbuffer_sink final : public base_sink<Mutex> {
@@ -26,8 +33,19 @@ public:
     explicit ringbuffer_sink(size_t n_items)
         : q_{n_items} {}
 
+    ringbuffer_sink(size_t n_items, size_t arena_size)
+        : ring_{n_items, arena_size},
+          use_ring_{true} {}
+
     void drain_raw(std::function<void(const details::log_msg_buffer &)> callback) {
         std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        if (use_ring_) {
+            while (!ring_.empty()) {
+                callback(details::log_msg_buffer{ring_.front()});
+                ring_.pop_front();
+            }
+            return;
+        }
         while (!q_.empty()) {
             callback(q_.front());
             q_.pop_front();
@@ -37,20 +55,38 @@ public:
     void drain(std::function<void(std::string_view)> callback) {
         std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
         memory_buf_t formatted;
-        while (!q_.empty()) {
+        auto format_msg = [&](const details::log_msg &msg) {
             formatted.clear();
-            base_sink<Mutex>::formatter_->format(q_.front(), formatted);
+            base_sink<Mutex>::formatter_->format(msg, formatted);
             callback(std::string_view(formatted.data(), formatted.size()));
+        };
+        if (use_ring_) {
+            while (!ring_.empty()) {
+                format_msg(ring_.front());
+                ring_.pop_front();
+            }
+            return;
+        }
+        while (!q_.empty()) {
+            format_msg(q_.front());
             q_.pop_front();
         }
     }
 
 protected:
-    void sink_it_(const details::log_msg &msg) override { q_.push_back(details::log_msg_buffer{msg}); }
+    void sink_it_(const details::log_msg &msg) override {
+        if (use_ring_) {
+            ring_.push_back(msg);
+        } else {
+            q_.push_back(details::log_msg_buffer{msg});
+        }
+    }
     void flush_() override {}
 
 private:
     details::circular_q<details::log_msg_buffer> q_;
+    details::log_msg_ring ring_;  // used instead of q_ if constructed with an arena size
+    bool use_ring_ = false;
 };
 
 using ringbuffer_sink_mt = ringbuffer_sink<std::mutex>;
@@ -3,19 +3,48 @@
 
 #pragma once
 
+#include <memory>
 #include <mutex>
 #include <string>
 
 #include "../details/file_helper.h"
 #include "../details/null_mutex.h"
+#include "../details/rotation_worker.h"
 #include "../details/synchronous_factory.h"
+#include "../disk_quota.h"
+#include "../file_compression.h"
 #include "./base_sink.h"
 
 namespace spdlog {
 namespace sinks {
+
+// How rotating_file_sink names the rotated files
+enum class rotation_naming {
+    // log.txt -> log.1.txt -> log.2.txt .. : every rotation renames all the files (max_files renames)
+    shift,
+    // log.1.txt, log.2.txt, log.3.txt .. : every rotation opens a file with the next index and deletes
+    // the oldest one. log.txt is a symbolic link to the current file (where supported).
+    monotonic
+};
+
 //
 // Rotating file sink based on size
 //
+// With set_background_rotation(true), the next file is opened ahead of time by a background thread,
+// so a rotation only switches to it. The renames (shift naming: the current file is renamed once and
+// the rest of the chain is shifted in the background), symlink updates and deletions of old files are
+// done by that thread. The next file is created on disk before it is used (shift naming: log.txt.next).
+// The before_open/after_open event handlers of the next file are therefore called on that thread, ahead of
+// time, with the name it is opened under (shift naming: log.txt.next, renamed to log.txt when used).
+// Shift naming: the files staged by a previous run that didn't complete its rotations are recovered on
+// construction. log.txt.rotated.N, rotated files not shifted to log.1.txt yet, are shifted into the chain
+// in sequence order (uncompressed), and log.txt.next is deleted if it is empty.
+//
+// With set_preallocation(true), the next file is also preallocated to max_size by that thread (see
+// details::file_helper), so writes don't allocate blocks or grow the file, and the oldest file is reused
+// as the next one instead of being deleted (unless the rotated files are compressed). Each file is
+// truncated to its written size when closed.
+//
 template <typename Mutex>
 class rotating_file_sink final : public base_sink<Mutex> {
 public:
@@ -23,23 +52,65 @@ public:
                        std::size_t max_size,
                        std::size_t max_files,
                        bool rotate_on_open = false,
-                       const file_event_handlers &event_handlers = {});
+                       const file_event_handlers &event_handlers = {},
+                       rotation_naming naming = rotation_naming::shift);
 
     static filename_t calc_filename(const filename_t &filename, std::size_t index);
     filename_t filename();
     void rotate_now();
+    // re-read the size of the current file, e.g. after it was truncated by another process.
+    // the size is otherwise tracked as it is written.
+    void resync_size();
+    // fsync the written data according to the given policy (see file_sync_policy.h)
+    void set_sync_policy(const file_sync_policy &policy);
+    // limit the page cache used by the written data (see page_cache_mode.h)
+    void set_page_cache_mode(page_cache_mode mode);
+    // do the file system work of rotations on a background thread.
+    // disabling it also disables compression_mode::rotated.
+    void set_background_rotation(bool enabled);
+    // wait until the background rotation work is done
+    void wait_background_rotation();
+    // time the logging thread was blocked by rotations
+    rotation_stats get_rotation_stats();
+    // gzip the files (see file_compression.h). compression_mode::rotated enables background rotation.
+    void set_compression(const file_compression &compression);
+    // preallocate the next files and reuse the oldest ones. enables background rotation.
+    void set_preallocation(bool enabled);
+    // share the disk quota (see disk_quota.h) with other sinks - the retained files are counted from now on.
+    // nullptr unregisters. requires rotation_naming::monotonic, throws spdlog_ex otherwise.
+    void set_disk_quota(std::shared_ptr<disk_quota> quota, quota_priority priority = quota_priority::normal);
 
 protected:
     void sink_it_(const details::log_msg &msg) override;
     void flush_() override;
 
 private:
+    // rotate and record the stall time
+    void rotate_();
     // Rotate files:
     // log.txt -> log.1.txt
     // log.1.txt -> log.2.txt
     // log.2.txt -> log.3.txt
     // log.3.txt -> delete
-    void rotate_();
+    void rotate_files_();
+    void rotate_background_();
+    // the file prepared by the background thread for the next rotation
+    filename_t next_filename_() const;
+    // shift naming, on the background thread: shift the chain and rename the rotated file to log.1.txt
+    // (compress it to log.1.txt.gz if compress_level > 0). the oldest file is renamed to reuse_as if not empty.
+    static void shift_files_(const filename_t &base_filename,
+                             std::size_t max_files,
+                             const filename_t &rotated,
+                             int compress_level,
+                             const filename_t &reuse_as);
+
+    // shift naming: recover the files staged by background rotations of a previous run that didn't complete
+    // (e.g. crashed). log.txt.rotated.N are shifted into the chain in sequence order, an empty log.txt.next is deleted.
+    void recover_staging_files_();
+    // monotonic naming: open the file with the given index and point the base filename link to it
+    void open_index_(std::size_t index);
+    // monotonic naming: find the last index used by previous runs and delete files beyond max_files
+    std::size_t scan_indices_();
 
     // delete the target if exists, and rename the src file  to target
     // return true on success, false otherwise.
@@ -48,8 +119,16 @@ private:
     filename_t base_filename_;
     std::size_t max_size_;
     std::size_t max_files_;
-    std::size_t current_size_;
+    rotation_naming naming_;
+    std::size_t index_ = 0;  // index of the current file (monotonic naming)
     details::file_helper file_helper_;
+    memory_buf_t formatted_;  // reused (under the sink's mutex) so large messages don't allocate every time
+    rotation_stats rotation_stats_;
+    std::size_t rotated_seq_ = 0;
+    int compress_level_ = 0;  // compression_mode::rotated level, 0 if disabled
+    bool preallocate_ = false;
+    std::unique_ptr<details::rotation_worker> worker_;  // uses file_helper_, so declared after it
+    std::unique_ptr<details::quota_client> quota_;
 };
 
 using rotating_file_sink_mt = rotating_file_sink<std::mutex>;
@@ -67,9 +146,10 @@ inline std::shared_ptr<logger> rotating_logger_mt(const std::string &logger_name
                                                   size_t max_file_size,
                                                   size_t max_files,
                                                   bool rotate_on_open = false,
-                                                  const file_event_handlers &event_handlers = {}) {
+                                                  const file_event_handlers &event_handlers = {},
+                                                  sinks::rotation_naming naming = sinks::rotation_naming::shift) {
     return Factory::template create<sinks::rotating_file_sink_mt>(logger_name, filename, max_file_size, max_files, rotate_on_open,
-                                                                  event_handlers);
+                                                                  event_handlers, naming);
 }
 
 template <typename Factory = spdlog::synchronous_factory>
@@ -78,8 +158,9 @@ inline std::shared_ptr<logger> rotating_logger_st(const std::string &logger_name
                                                   size_t max_file_size,
                                                   size_t max_files,
                                                   bool rotate_on_open = false,
-                                                  const file_event_handlers &event_handlers = {}) {
+                                                  const file_event_handlers &event_handlers = {},
+                                                  sinks::rotation_naming naming = sinks::rotation_naming::shift) {
     return Factory::template create<sinks::rotating_file_sink_st>(logger_name, filename, max_file_size, max_files, rotate_on_open,
-                                                                  event_handlers);
+                                                                  event_handlers, naming);
 }
 }  // namespace spdlog
@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+
 #include "../details/log_msg.h"
 #include "../formatter.h"
 
@@ -20,9 +23,17 @@ public:
     level log_level() const;
     bool should_log(level msg_level) const;
 
+    // changes whenever the level of any sink or logger changes (or the sinks of a logger may have), so
+    // loggers know when to recompute their effective level (see logger::should_log()).
+    static uint32_t levels_version() noexcept { return levels_version_.load(std::memory_order_acquire); }
+    static void levels_changed() noexcept;
+
 protected:
     // sink log level - default is all
     atomic_level_t level_{level::trace};
+
+private:
+    static std::atomic<uint32_t> levels_version_;
 };
 
 }  // namespace sinks
@@ -3,8 +3,11 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdio>
+#include <memory>
 
+#include "../details/console_flusher.h"
 #include "../details/null_mutex.h"
 #include "../details/synchronous_factory.h"
 #include "./base_sink.h"
@@ -18,11 +21,19 @@ namespace spdlog {
 
 namespace sinks {
 
+//
+// Writes to stdout/stderr (or another FILE*).
+// When the file is a terminal, every message is flushed. Otherwise (e.g. a pipe to a container log
+// collector) the messages are left in the stdio buffer, which is written when full, and flushed at least
+// every flush_interval (1 second by default) - see details/console_flusher.h.
+// set_flush_interval(0) flushes every message.
+// On windows the messages are written with WriteFile(), unbuffered.
+//
 template <typename Mutex>
 class stdout_sink_base : public base_sink<Mutex> {
 public:
     explicit stdout_sink_base(FILE *file);
-    ~stdout_sink_base() override = default;
+    ~stdout_sink_base() override;
 
     stdout_sink_base(const stdout_sink_base &other) = delete;
     stdout_sink_base(stdout_sink_base &&other) = delete;
@@ -30,6 +41,11 @@ public:
     stdout_sink_base &operator=(const stdout_sink_base &other) = delete;
     stdout_sink_base &operator=(stdout_sink_base &&other) = delete;
 
+    // max time messages may wait in the stdio buffer when not writing to a terminal (0 - flush every message)
+    void set_flush_interval(std::chrono::milliseconds interval);
+    // true if every message is flushed (writing to a terminal, or flush interval 0)
+    bool line_flush();
+
 private:
     FILE *file_;
     void sink_it_(const details::log_msg &msg) override;
@@ -37,6 +53,7 @@ private:
 #ifdef _WIN32
     HANDLE handle_;
 #endif  // _WIN32
+    details::console_flusher flusher_;
 };
 
 template <typename Mutex>
@@ -0,0 +1,371 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../common.h"
+#include "../details/file_helper.h"
+#include "../details/null_mutex.h"
+#include "../details/os.h"
+#include "../details/retention_index.h"
+#include "../details/rotation_worker.h"
+#include "../details/synchronous_factory.h"
+#include "../details/time_rotation.h"
+#include "../disk_quota.h"
+#include "../file_compression.h"
+#include "../fmt/fmt.h"
+#include "./base_sink.h"
+
+namespace spdlog {
+namespace sinks {
+
+/*
+ * Generator of log file names in format basename_YYYY-MM-DD_HH-MM.ext
+ */
+struct time_filename_calculator {
+    static filename_t calc_filename(const filename_t &filename, const tm &now_tm) {
+        fmt_lib::basic_memory_buffer<char, 32> suffix;
+        fmt_lib::format_to(std::back_inserter(suffix), "_{:04d}-{:02d}-{:02d}_{:02d}-{:02d}", now_tm.tm_year + 1900,
+                           now_tm.tm_mon + 1, now_tm.tm_mday, now_tm.tm_hour, now_tm.tm_min);
+        return details::insert_before_extension(filename, string_view_t{suffix.data(), suffix.size()});
+    }
+};
+
+/*
+ * Rotating file sink based on time - a new file every interval (see details/time_rotation.h).
+ * Also the base of daily_file_sink and hourly_file_sink.
+ * The file name is calculated from the local start time of its period.
+ * If truncate != false , the created file will be truncated.
+ * If max_files > 0, retain only the last max_files and delete previous.
+ * set_max_size() also limits the total size of the files.
+ * The retained files, including those left by previous executions, are found by one scan of the log directory
+ * on construction (see details/retention_index.h) - the oldest over the limits are deleted right away.
+ */
+template <typename Mutex, typename FileNameCalc = time_filename_calculator>
+class time_file_sink : public base_sink<Mutex> {
+public:
+    // create a file sink which rotates every interval (e.g. 15 minutes), starting at midnight
+    time_file_sink(filename_t base_filename,
+                   std::chrono::minutes interval,
+                   bool truncate = false,
+                   uint16_t max_files = 0,
+                   const file_event_handlers &event_handlers = {})
+        : time_file_sink(std::move(base_filename), details::time_rotation{interval}, truncate, max_files, event_handlers) {}
+
+    filename_t filename() {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        return file_helper_.filename();
+    }
+
+    // fsync the written data according to the given policy (see file_sync_policy.h)
+    void set_sync_policy(const file_sync_policy &policy) {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        file_helper_.set_sync_policy(policy);
+    }
+
+    // limit the page cache used by the written data (see page_cache_mode.h)
+    void set_page_cache_mode(page_cache_mode mode) {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        file_helper_.set_page_cache_mode(mode);
+    }
+
+    // open the next file ahead of time and delete old files on a background thread.
+    // note that the next file is created on disk before its time comes, and that its before_open/after_open
+    // event handlers are called then, on that thread. disabling it also disables compression_mode::rotated.
+    void set_background_rotation(bool enabled) {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        worker_.reset();  // finishes the pending work
+        if (enabled) {
+            worker_ = std::make_unique<details::rotation_worker>();
+            prepare_next_();
+        } else {
+            compress_level_ = 0;  // compression_mode::rotated needs the worker
+        }
+    }
+
+    // wait until the background rotation work is done
+    void wait_background_rotation() {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        if (worker_) {
+            worker_->wait_idle();
+        }
+    }
+
+    // time the logging thread was blocked by rotations
+    rotation_stats get_rotation_stats() {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        return rotation_stats_;
+    }
+
+    // also delete the oldest files while the total size of the files is over max_bytes (0 - no limit).
+    // applied now and on every rotation. the current file is never deleted.
+    void set_max_size(size_t max_bytes) {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        retention_.set_limits(max_files_, max_bytes);
+        if (!retention_.scanned()) {
+            if (max_bytes == 0) {
+                return;
+            }
+            init_retention_();
+        }
+        delete_old_();
+    }
+
+    // share the disk quota (see disk_quota.h) with other sinks - the retained files are counted from now on.
+    // nullptr unregisters.
+    void set_disk_quota(std::shared_ptr<disk_quota> quota, quota_priority priority = quota_priority::normal) {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        quota_.reset();
+        if (!quota) {
+            return;
+        }
+        quota_ = std::make_unique<details::quota_client>(std::move(quota), priority);
+        if (!retention_.scanned()) {
+            init_retention_();
+        }
+        for (const auto &file : retention_.entries()) {
+            if (file.filename != file_helper_.filename()) {
+                quota_->add_existing(file.filename);
+            }
+        }
+        quota_->set_current(file_helper_.filename(), file_helper_.size());
+    }
+
+    // gzip the files (see file_compression.h). compression_mode::rotated enables background rotation.
+    void set_compression(const file_compression &compression) {
+        std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+        if (compression.mode != compression_mode::none && !details::gzip_available()) {
+            throw_spdlog_ex("time_file_sink: gzip compression is not available - spdlog was built without SPDLOG_ZLIB");
+        }
+        file_helper_.set_compression(compression.mode == compression_mode::live ? compression.level : 0);
+        compress_level_ = 0;
+        if (compression.mode == compression_mode::rotated) {
+            if (!worker_) {
+                worker_ = std::make_unique<details::rotation_worker>();
+                prepare_next_();
+            }
+            compress_level_ = compression.level;
+        }
+    }
+
+protected:
+    // remove_empty_first_file: delete the file opened on construction at the first rotation if it was
+    // empty when opened and nothing was written to it.
+    time_file_sink(filename_t base_filename,
+                   details::time_rotation rotation,
+                   bool truncate,
+                   uint16_t max_files,
+                   const file_event_handlers &event_handlers,
+                   bool remove_empty_first_file = false)
+        : base_filename_(std::move(base_filename)),
+          rotation_(rotation),
+          file_helper_{event_handlers},
+          truncate_(truncate),
+          max_files_(max_files),
+          retention_{max_files, 0} {
+        const auto period = rotation_.period_of(log_clock::now());
+        file_helper_.open(FileNameCalc::calc_filename(base_filename_, period.start_tm), truncate_);
+        remove_init_file_ = remove_empty_first_file && file_helper_.size() == 0;
+        rotation_tp_ = period.end;
+
+        if (max_files_ > 0) {
+            init_retention_();
+            delete_old_();
+        }
+    }
+
+    void sink_it_(const details::log_msg &msg) override {
+        if (quota_ && !quota_->sample()) {
+            return;
+        }
+        bool should_rotate = msg.time >= rotation_tp_;
+        std::chrono::steady_clock::time_point rotation_start;
+        if (should_rotate) {
+            rotation_start = std::chrono::steady_clock::now();
+            filename_t previous;
+            if (remove_init_file_) {
+                file_helper_.close();
+                details::os::remove(file_helper_.filename());
+                if (retention_.scanned()) {
+                    retention_.remove(file_helper_.filename());
+                }
+                if (quota_) {
+                    quota_->removed(file_helper_.filename());
+                }
+            } else {
+                previous = file_helper_.filename();
+                // not indexed without limits (max_files 0), so the index doesn't grow with every rotation
+                if (retention_.scanned()) {
+                    retention_.set_current(previous, file_helper_.size());
+                }
+            }
+            const auto period = rotation_.period_of(msg.time);
+            open_(FileNameCalc::calc_filename(base_filename_, period.start_tm));
+            if (quota_) {
+                quota_->set_current(file_helper_.filename(), file_helper_.size());
+            }
+            compress_(previous);
+            rotation_tp_ = period.end;
+            prepare_next_();
+        }
+        remove_init_file_ = false;
+        formatted_.clear();
+        base_sink<Mutex>::formatter_->format(msg, formatted_);
+        file_helper_.write(formatted_);
+        file_helper_.sync_by_policy(msg.log_level);
+        if (quota_) {
+            quota_->written(formatted_.size());
+        }
+
+        // Do the cleaning only at the end because it might throw on failure.
+        if (should_rotate) {
+            if (retention_.scanned()) {
+                retention_.set_current(file_helper_.filename(), file_helper_.size());
+                delete_old_();
+            }
+            rotation_stats_.add(std::chrono::steady_clock::now() - rotation_start);
+            if (worker_) {
+                worker_->check_error();
+            }
+        }
+    }
+
+    void flush_() override { file_helper_.flush(); }
+
+private:
+    // switch to the given file - the one opened by the background thread if it is ready
+    void open_(const filename_t &filename) {
+        std::FILE *fp = worker_ ? worker_->take_prepared(filename) : nullptr;
+        if (fp != nullptr) {
+            file_helper_.adopt(fp, filename);
+        } else {
+            file_helper_.open(filename, truncate_);
+        }
+    }
+
+    // compress the file rotated from in the background, unless it was reopened
+    void compress_(const filename_t &previous) {
+        if (!worker_ || compress_level_ == 0 || previous.empty() || previous == file_helper_.filename()) {
+            return;
+        }
+        worker_->post([previous, level = compress_level_] {
+            details::gzip_file(previous, filename_t(previous) += SPDLOG_FILENAME_T(".gz"), level);
+            details::os::remove(previous);
+        });
+    }
+
+    void prepare_next_() {
+        if (worker_) {
+            const auto next = rotation_.period_of(rotation_tp_);
+            worker_->prepare(file_helper_, FileNameCalc::calc_filename(base_filename_, next.start_tm), truncate_);
+        }
+    }
+
+    // index the files of this sink from a scan of the log directory
+    void init_retention_() {
+        // names rendered from times that differ in every digit, so the pattern matches any time
+        std::tm sample1{};
+        sample1.tm_year = 100;  // 2000-01-01 00:00:00, a saturday
+        sample1.tm_mday = 1;
+        sample1.tm_wday = 6;
+        std::tm sample2{};
+        sample2.tm_year = 11;  // 1911-12-22 13:11:11, a friday
+        sample2.tm_mon = 11;
+        sample2.tm_mday = 22;
+        sample2.tm_hour = 13;
+        sample2.tm_min = 11;
+        sample2.tm_sec = 11;
+        sample2.tm_wday = 5;
+        sample2.tm_yday = 355;
+        retention_.scan(FileNameCalc::calc_filename(base_filename_, sample1),
+                        FileNameCalc::calc_filename(base_filename_, sample2));
+        retention_.set_current(file_helper_.filename(), file_helper_.size());
+    }
+
+    // Delete the oldest files over the retention limits (in the background if enabled).
+    // Throw spdlog_ex on failure to delete a file.
+    void delete_old_() {
+        using details::os::filename_to_str;
+        using details::os::path_exists;
+        using details::os::remove_if_exists;
+
+        filename_t failed;
+        int failed_errno = 0;
+        for (auto &old_filename : retention_.expire()) {
+            if (quota_) {
+                quota_->removed(old_filename);
+            }
+            if (worker_) {
+                worker_->post([old_filename] {
+                    remove_if_exists(old_filename);
+                    remove_if_exists(filename_t(old_filename) += SPDLOG_FILENAME_T(".gz"));
+                });
+                continue;
+            }
+            const filename_t gz_filename = filename_t(old_filename) += SPDLOG_FILENAME_T(".gz");
+            remove_if_exists(old_filename);
+            remove_if_exists(gz_filename);
+            if ((path_exists(old_filename) || path_exists(gz_filename)) && failed.empty()) {
+                failed = old_filename;
+                failed_errno = errno;
+            }
+        }
+        if (!failed.empty()) {
+            throw_spdlog_ex("Failed removing file " + filename_to_str(failed), failed_errno);
+        }
+    }
+
+    filename_t base_filename_;
+    details::time_rotation rotation_;
+    log_clock::time_point rotation_tp_;
+    details::file_helper file_helper_;
+    bool truncate_;
+    uint16_t max_files_;
+    details::retention_index retention_;
+    memory_buf_t formatted_;  // reused (under the sink's mutex) so large messages don't allocate every time
+    rotation_stats rotation_stats_;
+    int compress_level_ = 0;  // compression_mode::rotated level, 0 if disabled
+    std::unique_ptr<details::rotation_worker> worker_;  // uses file_helper_, so declared after it
+    std::unique_ptr<details::quota_client> quota_;
+    bool remove_init_file_ = false;
+};
+
+using time_file_sink_mt = time_file_sink<std::mutex>;
+using time_file_sink_st = time_file_sink<details::null_mutex>;
+
+}  // namespace sinks
+
+//
+// factory functions
+//
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> time_logger_mt(const std::string &logger_name,
+                                              const filename_t &filename,
+                                              std::chrono::minutes interval,
+                                              bool truncate = false,
+                                              uint16_t max_files = 0,
+                                              const file_event_handlers &event_handlers = {}) {
+    return Factory::template create<sinks::time_file_sink_mt>(logger_name, filename, interval, truncate, max_files,
+                                                              event_handlers);
+}
+
+template <typename Factory = spdlog::synchronous_factory>
+inline std::shared_ptr<logger> time_logger_st(const std::string &logger_name,
+                                              const filename_t &filename,
+                                              std::chrono::minutes interval,
+                                              bool truncate = false,
+                                              uint16_t max_files = 0,
+                                              const file_event_handlers &event_handlers = {}) {
+    return Factory::template create<sinks::time_file_sink_st>(logger_name, filename, interval, truncate, max_files,
+                                                              event_handlers);
+}
+}  // namespace spdlog
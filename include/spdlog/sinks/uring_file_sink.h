@@ -0,0 +1,112 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#ifndef __linux__
+    #error "uring_file_sink is only available on linux"
+#endif
+
+#include <sys/uio.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../details/file_helper.h"
+#include "../details/null_mutex.h"
+#include "../details/synchronous_factory.h"
+#include "./base_sink.h"
+
+namespace spdlog {
+namespace details {
+class uring;
+}
+
+namespace sinks {
+/*
+ * Linux file sink that writes with io_uring.
+ * Formatted messages are collected in one of buffers_count buffers (of buffer_size bytes each).
+ * A full buffer is submitted to io_uring and the sink moves on to the next one, so formatting
+ * keeps going while previous buffers are being written. The sink blocks only when all buffers
+ * are in flight.
+ * flush() submits the current buffer and waits for all writes to complete. sync() also fsyncs.
+ *
+ * If io_uring is not available (old kernel, seccomp), falls back to plain pwrite() of full buffers.
+ * The file is opened by file_helper, so the file event handlers behave as in basic_file_sink.
+ */
+template <typename Mutex>
+class uring_file_sink final : public base_sink<Mutex> {
+public:
+    static constexpr size_t default_buffer_size = 64 * 1024;
+    static constexpr size_t default_buffers_count = 4;
+
+    explicit uring_file_sink(const filename_t &filename,
+                             bool truncate = false,
+                             const file_event_handlers &event_handlers = {},
+                             size_t buffer_size = default_buffer_size,
+                             size_t buffers_count = default_buffers_count);
+    ~uring_file_sink() override;
+
+    const filename_t &filename() const;
+    // false if fell back to plain writes
+    bool uring_enabled() const;
+    // write all pending data and fsync the file
+    void sync();
+
+protected:
+    void sink_it_(const details::log_msg &msg) override;
+    void flush_() override;
+
+private:
+    struct buffer {
+        std::unique_ptr<char[]> data;
+        size_t size = 0;
+        std::uint64_t offset = 0;
+        iovec iov{};  // submitted with the write request
+        bool in_flight = false;
+    };
+
+    void submit_current_();
+    void wait_completion_();
+    void wait_all_();
+    void write_at_(const char *data, size_t size, std::uint64_t offset);
+    void close_();
+
+    details::file_helper file_helper_;
+    int fd_ = -1;
+    std::uint64_t offset_ = 0;  // file offset of the next write
+    size_t buffer_size_;
+    std::vector<buffer> buffers_;
+    size_t current_ = 0;
+    size_t in_flight_ = 0;
+    std::unique_ptr<details::uring> uring_;  // null if io_uring is not available
+    memory_buf_t formatted_;
+};
+
+using uring_file_sink_mt = uring_file_sink<std::mutex>;
+using uring_file_sink_st = uring_file_sink<details::null_mutex>;
+
+}  // namespace sinks
+
+//
+// factory functions
+//
+template <typename Factory = spdlog::synchronous_factory>
+std::shared_ptr<logger> uring_logger_mt(const std::string &logger_name,
+                                        const filename_t &filename,
+                                        bool truncate = false,
+                                        const file_event_handlers &event_handlers = {}) {
+    return Factory::template create<sinks::uring_file_sink_mt>(logger_name, filename, truncate, event_handlers);
+}
+
+template <typename Factory = spdlog::synchronous_factory>
+std::shared_ptr<logger> uring_logger_st(const std::string &logger_name,
+                                        const filename_t &filename,
+                                        bool truncate = false,
+                                        const file_event_handlers &event_handlers = {}) {
+    return Factory::template create<sinks::uring_file_sink_st>(logger_name, filename, truncate, event_handlers);
+}
+
+}  // namespace spdlog
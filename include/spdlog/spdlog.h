@@ -13,10 +13,12 @@
 #include <string>
 #include <string_view>
 
+#include "./call_site.h"
 #include "./common.h"
 #include "./details/context.h"
 #include "./details/synchronous_factory.h"
 #include "./logger.h"
+#include "./mdc.h"
 
 namespace spdlog {
 
@@ -64,7 +66,7 @@ SPDLOG_API void shutdown();
 //
 // The global logger object can be accessed using the spdlog::global_logger():
 // For example, to add another sink to it:
-// spdlog::global_logger()->sinks().push_back(some_sink);
+// spdlog::global_logger()->add_sink(some_sink);
 //
 // The global logger can be replaced using spdlog::set_global_logger(new_logger).
 // For example, to replace it with a file logger.
@@ -139,6 +141,48 @@ inline void error(std::string_view msg) { log(level::err, msg); }
 
 inline void critical(std::string_view msg) { log(level::critical, msg); }
 
+// log functions with string message and key/value fields
+// e.g: spdlog::info("order filled", spdlog::kv("id", id), spdlog::kv("px", px));
+template <typename... Fields, std::enable_if_t<details::is_log_fields_v<Fields...>, int> = 0>
+void log(level lvl, std::string_view msg, const Fields &...fields) {
+    global_logger_raw()->log(lvl, msg, fields...);
+}
+
+template <typename... Fields, std::enable_if_t<details::is_log_fields_v<Fields...>, int> = 0>
+void log(source_loc loc, level lvl, std::string_view msg, const Fields &...fields) {
+    global_logger_raw()->log(loc, lvl, msg, fields...);
+}
+
+template <typename... Fields, std::enable_if_t<details::is_log_fields_v<Fields...>, int> = 0>
+void trace(std::string_view msg, const Fields &...fields) {
+    log(level::trace, msg, fields...);
+}
+
+template <typename... Fields, std::enable_if_t<details::is_log_fields_v<Fields...>, int> = 0>
+void debug(std::string_view msg, const Fields &...fields) {
+    log(level::debug, msg, fields...);
+}
+
+template <typename... Fields, std::enable_if_t<details::is_log_fields_v<Fields...>, int> = 0>
+void info(std::string_view msg, const Fields &...fields) {
+    log(level::info, msg, fields...);
+}
+
+template <typename... Fields, std::enable_if_t<details::is_log_fields_v<Fields...>, int> = 0>
+void warn(std::string_view msg, const Fields &...fields) {
+    log(level::warn, msg, fields...);
+}
+
+template <typename... Fields, std::enable_if_t<details::is_log_fields_v<Fields...>, int> = 0>
+void error(std::string_view msg, const Fields &...fields) {
+    log(level::err, msg, fields...);
+}
+
+template <typename... Fields, std::enable_if_t<details::is_log_fields_v<Fields...>, int> = 0>
+void critical(std::string_view msg, const Fields &...fields) {
+    log(level::critical, msg, fields...);
+}
+
 }  // namespace spdlog
 
 //
@@ -154,59 +198,112 @@ inline void critical(std::string_view msg) { log(level::critical, msg); }
 // SPDLOG_LEVEL_OFF
 //
 
+//
+// each call site has a static descriptor, which can be enabled or disabled at runtime (see call_site.h).
+// the descriptor of a call with a constant level is constant-initialized. with a runtime level it is
+// initialized on the first hit (behind a static guard), and call_sites() reports the level of that hit.
+//
+// BREAKING CHANGE: the macros are statements (do {...} while (0)) rather than expressions, so they can't
+// be used in ternaries or comma expressions anymore. the logger expression and the arguments are evaluated
+// only if the call logs, so side effects in the arguments of calls that don't log are dropped. this is
+// the same with SPDLOG_NO_SOURCE_LOC, which has no call sites but checks the logger's level first.
+//
+// the lazy versions (e.g. SPDLOG_LOGGER_DEBUG_LAZY(logger, "state: {}", expensive_dump())) are aliases of
+// the regular macros.
+//
 #ifndef SPDLOG_NO_SOURCE_LOC
-    #define SPDLOG_LOGGER_CALL(logger, level, ...) \
-        (logger)->log(spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION}, level, __VA_ARGS__)
+    #define SPDLOG_LOGGER_CALL(logger, level, ...)                                                             \
+        do {                                                                                                   \
+            static spdlog::call_site spdlog_call_site_{__FILE__, __LINE__, SPDLOG_FUNCTION, level};            \
+            const auto spdlog_call_site_state_ = spdlog_call_site_.state();                                    \
+            if (spdlog_call_site_state_ != spdlog::call_site_state::disabled) {                                \
+                auto &&spdlog_call_site_logger_ = (logger);                                                    \
+                if (spdlog_call_site_.should_log(spdlog_call_site_state_, *spdlog_call_site_logger_, level)) { \
+                    spdlog_call_site_logger_->force_log(spdlog_call_site_.location(), level, __VA_ARGS__);     \
+                }                                                                                              \
+            }                                                                                                  \
+        } while (0)
 #else
-    #define SPDLOG_LOGGER_CALL(logger, level, ...) (logger)->log(spdlog::source_loc{}, level, __VA_ARGS__)
+    #define SPDLOG_LOGGER_CALL(logger, level, ...)                                        \
+        do {                                                                              \
+            auto &&spdlog_call_logger_ = (logger);                                        \
+            if (spdlog_call_logger_->should_log(level)) {                                 \
+                spdlog_call_logger_->force_log(spdlog::source_loc{}, level, __VA_ARGS__); \
+            }                                                                             \
+        } while (0)
 #endif
+#define SPDLOG_LOGGER_CALL_LAZY(logger, level, ...) SPDLOG_LOGGER_CALL(logger, level, __VA_ARGS__)
 
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
     #define SPDLOG_LOGGER_TRACE(logger, ...) SPDLOG_LOGGER_CALL(logger, spdlog::level::trace, __VA_ARGS__)
     #define SPDLOG_TRACE(...) SPDLOG_LOGGER_TRACE(spdlog::global_logger_raw(), __VA_ARGS__)
+    #define SPDLOG_LOGGER_TRACE_LAZY(logger, ...) SPDLOG_LOGGER_CALL_LAZY(logger, spdlog::level::trace, __VA_ARGS__)
+    #define SPDLOG_TRACE_LAZY(...) SPDLOG_LOGGER_TRACE_LAZY(spdlog::global_logger_raw(), __VA_ARGS__)
 #else
     #define SPDLOG_LOGGER_TRACE(logger, ...) (void)0
     #define SPDLOG_TRACE(...) (void)0
+    #define SPDLOG_LOGGER_TRACE_LAZY(logger, ...) (void)0
+    #define SPDLOG_TRACE_LAZY(...) (void)0
 #endif
 
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
     #define SPDLOG_LOGGER_DEBUG(logger, ...) SPDLOG_LOGGER_CALL(logger, spdlog::level::debug, __VA_ARGS__)
     #define SPDLOG_DEBUG(...) SPDLOG_LOGGER_DEBUG(spdlog::global_logger(), __VA_ARGS__)
+    #define SPDLOG_LOGGER_DEBUG_LAZY(logger, ...) SPDLOG_LOGGER_CALL_LAZY(logger, spdlog::level::debug, __VA_ARGS__)
+    #define SPDLOG_DEBUG_LAZY(...) SPDLOG_LOGGER_DEBUG_LAZY(spdlog::global_logger_raw(), __VA_ARGS__)
 #else
     #define SPDLOG_LOGGER_DEBUG(logger, ...) (void)0
     #define SPDLOG_DEBUG(...) (void)0
+    #define SPDLOG_LOGGER_DEBUG_LAZY(logger, ...) (void)0
+    #define SPDLOG_DEBUG_LAZY(...) (void)0
 #endif
 
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
     #define SPDLOG_LOGGER_INFO(logger, ...) SPDLOG_LOGGER_CALL(logger, spdlog::level::info, __VA_ARGS__)
     #define SPDLOG_INFO(...) SPDLOG_LOGGER_INFO(spdlog::global_logger(), __VA_ARGS__)
+    #define SPDLOG_LOGGER_INFO_LAZY(logger, ...) SPDLOG_LOGGER_CALL_LAZY(logger, spdlog::level::info, __VA_ARGS__)
+    #define SPDLOG_INFO_LAZY(...) SPDLOG_LOGGER_INFO_LAZY(spdlog::global_logger_raw(), __VA_ARGS__)
 #else
     #define SPDLOG_LOGGER_INFO(logger, ...) (void)0
     #define SPDLOG_INFO(...) (void)0
+    #define SPDLOG_LOGGER_INFO_LAZY(logger, ...) (void)0
+    #define SPDLOG_INFO_LAZY(...) (void)0
 #endif
 
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
     #define SPDLOG_LOGGER_WARN(logger, ...) SPDLOG_LOGGER_CALL(logger, spdlog::level::warn, __VA_ARGS__)
     #define SPDLOG_WARN(...) SPDLOG_LOGGER_WARN(spdlog::global_logger(), __VA_ARGS__)
+    #define SPDLOG_LOGGER_WARN_LAZY(logger, ...) SPDLOG_LOGGER_CALL_LAZY(logger, spdlog::level::warn, __VA_ARGS__)
+    #define SPDLOG_WARN_LAZY(...) SPDLOG_LOGGER_WARN_LAZY(spdlog::global_logger_raw(), __VA_ARGS__)
 #else
     #define SPDLOG_LOGGER_WARN(logger, ...) (void)0
     #define SPDLOG_WARN(...) (void)0
+    #define SPDLOG_LOGGER_WARN_LAZY(logger, ...) (void)0
+    #define SPDLOG_WARN_LAZY(...) (void)0
 #endif
 
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
     #define SPDLOG_LOGGER_ERROR(logger, ...) SPDLOG_LOGGER_CALL(logger, spdlog::level::err, __VA_ARGS__)
     #define SPDLOG_ERROR(...) SPDLOG_LOGGER_ERROR(spdlog::global_logger(), __VA_ARGS__)
+    #define SPDLOG_LOGGER_ERROR_LAZY(logger, ...) SPDLOG_LOGGER_CALL_LAZY(logger, spdlog::level::err, __VA_ARGS__)
+    #define SPDLOG_ERROR_LAZY(...) SPDLOG_LOGGER_ERROR_LAZY(spdlog::global_logger_raw(), __VA_ARGS__)
 #else
     #define SPDLOG_LOGGER_ERROR(logger, ...) (void)0
     #define SPDLOG_ERROR(...) (void)0
+    #define SPDLOG_LOGGER_ERROR_LAZY(logger, ...) (void)0
+    #define SPDLOG_ERROR_LAZY(...) (void)0
 #endif
 
 #if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_CRITICAL
     #define SPDLOG_LOGGER_CRITICAL(logger, ...) SPDLOG_LOGGER_CALL(logger, spdlog::level::critical, __VA_ARGS__)
     #define SPDLOG_CRITICAL(...) SPDLOG_LOGGER_CRITICAL(spdlog::global_logger(), __VA_ARGS__)
+    #define SPDLOG_LOGGER_CRITICAL_LAZY(logger, ...) SPDLOG_LOGGER_CALL_LAZY(logger, spdlog::level::critical, __VA_ARGS__)
+    #define SPDLOG_CRITICAL_LAZY(...) SPDLOG_LOGGER_CRITICAL_LAZY(spdlog::global_logger_raw(), __VA_ARGS__)
 #else
     #define SPDLOG_LOGGER_CRITICAL(logger, ...) (void)0
     #define SPDLOG_CRITICAL(...) (void)0
+    #define SPDLOG_LOGGER_CRITICAL_LAZY(logger, ...) (void)0
+    #define SPDLOG_CRITICAL_LAZY(...) (void)0
 #endif
 
 #endif  // SPDLOG_H
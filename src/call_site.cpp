@@ -0,0 +1,148 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "spdlog/call_site.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace spdlog {
+namespace details {
+
+// the registered call sites (static objects, never removed - see call_site.h) and the rules applied to them
+class call_site_registry {
+public:
+    static call_site_registry &instance() {
+        static call_site_registry registry;
+        return registry;
+    }
+
+    call_site_state register_site(call_site &site) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto state = site.state_.load(std::memory_order_relaxed);
+        if (state != call_site_state::unregistered) {
+            return state;  // registered by another thread meanwhile
+        }
+        sites_.push_back(&site);
+        state = call_site_state::normal;
+        for (const auto &r : rules_) {
+            if (matches_(r, site)) {
+                state = r.state;
+            }
+        }
+        site.state_.store(state, std::memory_order_relaxed);
+        return state;
+    }
+
+    void add_rule(const std::string &file_glob, const std::string &func_glob, call_site_state state) {
+        const rule r{file_glob, func_glob, state};
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (state == call_site_state::normal && file_glob == "*" && func_glob == "*") {
+            rules_.clear();
+        } else {
+            // a rule with the same globs is replaced, and the new one applies last
+            rules_.erase(std::remove_if(rules_.begin(), rules_.end(),
+                                        [&r](const rule &other) {
+                                            return other.file_glob == r.file_glob && other.func_glob == r.func_glob;
+                                        }),
+                         rules_.end());
+            rules_.push_back(r);
+        }
+        for (auto *site : sites_) {
+            if (matches_(r, *site)) {
+                site->state_.store(state, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::vector<call_site_info> sites() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<call_site_info> result;
+        result.reserve(sites_.size());
+        for (const auto *site : sites_) {
+            result.push_back(call_site_info{site->location_, site->level_, site->state_.load(std::memory_order_relaxed),
+                                            site->hits_.load(std::memory_order_relaxed)});
+        }
+        std::stable_sort(result.begin(), result.end(),
+                         [](const call_site_info &a, const call_site_info &b) { return a.hits > b.hits; });
+        return result;
+    }
+
+    void reset_hits() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto *site : sites_) {
+            site->hits_.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct rule {
+        std::string file_glob;
+        std::string func_glob;
+        call_site_state state;
+    };
+
+    // '*' matches any sequence, '?' any character
+    static bool glob_match_(const char *pattern, const char *str) {
+        const char *star = nullptr;
+        const char *star_str = nullptr;
+        while (*str) {
+            if (*pattern == '?' || *pattern == *str) {
+                ++pattern;
+                ++str;
+            } else if (*pattern == '*') {
+                star = pattern++;
+                star_str = str;
+            } else if (star != nullptr) {
+                pattern = star + 1;
+                str = ++star_str;
+            } else {
+                return false;
+            }
+        }
+        while (*pattern == '*') {
+            ++pattern;
+        }
+        return *pattern == '\0';
+    }
+
+    static bool matches_(const rule &r, const call_site &site) {
+        const auto &loc = site.location_;
+        const char *funcname = loc.funcname != nullptr ? loc.funcname : "";
+        const bool file_match = loc.filename != nullptr && (glob_match_(r.file_glob.c_str(), loc.filename) ||
+                                                            glob_match_(r.file_glob.c_str(), loc.short_filename));
+        return file_match && glob_match_(r.func_glob.c_str(), funcname);
+    }
+
+    std::mutex mutex_;
+    std::vector<call_site *> sites_;
+    std::vector<rule> rules_;
+};
+
+}  // namespace details
+
+call_site_state call_site::register_() noexcept {
+    try {
+        return details::call_site_registry::instance().register_site(*this);
+    } catch (...) {
+        return call_site_state::normal;  // not registered, retried on the next hit
+    }
+}
+
+void enable_call_sites(const std::string &file_glob, const std::string &func_glob) {
+    details::call_site_registry::instance().add_rule(file_glob, func_glob, call_site_state::enabled);
+}
+
+void disable_call_sites(const std::string &file_glob, const std::string &func_glob) {
+    details::call_site_registry::instance().add_rule(file_glob, func_glob, call_site_state::disabled);
+}
+
+void reset_call_sites(const std::string &file_glob, const std::string &func_glob) {
+    details::call_site_registry::instance().add_rule(file_glob, func_glob, call_site_state::normal);
+}
+
+std::vector<call_site_info> call_sites() { return details::call_site_registry::instance().sites(); }
+
+void reset_call_site_hits() { details::call_site_registry::instance().reset_hits(); }
+
+}  // namespace spdlog
@@ -8,6 +8,19 @@
 
 namespace spdlog {
 
+#ifdef SPDLOG_MEMORY_RESOURCE
+static std::atomic<std::pmr::memory_resource *> global_memory_resource{nullptr};
+
+void set_memory_resource(std::pmr::memory_resource *resource) noexcept {
+    global_memory_resource.store(resource, std::memory_order_release);
+}
+
+std::pmr::memory_resource *get_memory_resource() noexcept {
+    auto *resource = global_memory_resource.load(std::memory_order_acquire);
+    return resource != nullptr ? resource : std::pmr::new_delete_resource();
+}
+#endif
+
 spdlog::level level_from_str(const std::string &name) noexcept {
     const auto it = std::find(std::begin(level_string_views), std::end(level_string_views), name);
     if (it != std::end(level_string_views)) return static_cast<level>(std::distance(std::begin(level_string_views), it));
@@ -26,7 +39,7 @@ spdlog_ex::spdlog_ex(std::string msg)
     : msg_(std::move(msg)) {}
 
 spdlog_ex::spdlog_ex(const std::string &msg, int last_errno) {
-    memory_buf_t outbuf;
+    fmt::memory_buffer outbuf;
     fmt::format_system_error(outbuf, last_errno, msg.c_str());
     msg_ = fmt::to_string(outbuf);
 }
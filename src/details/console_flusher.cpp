@@ -0,0 +1,34 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "spdlog/details/console_flusher.h"
+
+#include <utility>
+
+#include "spdlog/details/os.h"
+
+namespace spdlog {
+namespace details {
+
+console_flusher::console_flusher(FILE *file, std::function<void()> on_timer)
+    : file_(file),
+      on_timer_(std::move(on_timer)),
+      terminal_(os::in_terminal(file)),
+      last_flush_(log_clock::now()) {}
+
+void console_flusher::written(log_clock::time_point time) {
+    if (line_flush() || time - last_flush_ >= interval_) {
+        std::fflush(file_);
+        last_flush_ = time;
+    } else if (!timer_ && on_timer_) {
+        timer_ = std::make_unique<periodic_worker>(on_timer_, interval_);
+    }
+}
+
+std::unique_ptr<periodic_worker> console_flusher::set_interval(std::chrono::milliseconds interval) {
+    interval_ = interval;
+    return std::move(timer_);  // restarted with the new interval by the next message
+}
+
+}  // namespace details
+}  // namespace spdlog
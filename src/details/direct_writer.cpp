@@ -0,0 +1,125 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "spdlog/details/direct_writer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include "spdlog/details/os.h"
+
+namespace spdlog {
+namespace details {
+
+static constexpr std::align_val_t buffer_alignment{direct_writer::alignment};
+
+void direct_writer::buffer_deleter::operator()(char *p) const noexcept { ::operator delete(p, buffer_alignment); }
+
+direct_writer::direct_writer(int fd, size_t file_size, size_t buffer_size, filename_t filename)
+    : fd_{fd},
+      filename_{std::move(filename)},
+      buffer_size_{(std::max)((buffer_size + alignment - 1) / alignment * alignment, alignment)} {
+    for (auto &buffer : buffers_) {
+        buffer.reset(static_cast<char *>(::operator new(buffer_size_, buffer_alignment)));
+    }
+    // continue from the start of the last block, with its content
+    offset_ = file_size / alignment * alignment;
+    filled_ = file_size - offset_;
+    if (filled_ > 0 && os::pread_bytes(fd_, buffers_[0].get(), alignment, offset_) < static_cast<long long>(filled_)) {
+        throw_spdlog_ex("Failed reading file " + os::filename_to_str(filename_), errno);
+    }
+    thread_ = std::thread([this] { run_(); });
+}
+
+direct_writer::~direct_writer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+void direct_writer::write(const char *data, size_t n) {
+    while (n > 0) {
+        const size_t chunk = (std::min)(n, buffer_size_ - filled_);
+        std::memcpy(buffers_[active_].get() + filled_, data, chunk);
+        filled_ += chunk;
+        data += chunk;
+        n -= chunk;
+        if (filled_ == buffer_size_) {
+            submit_();
+        }
+    }
+}
+
+void direct_writer::flush() {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wait_idle_(lock);
+    }
+    if (filled_ == 0) {
+        return;
+    }
+    char *buffer = buffers_[active_].get();
+    const size_t padded = (filled_ + alignment - 1) / alignment * alignment;
+    std::memset(buffer + filled_, 0, padded - filled_);
+    if (!os::pwrite_bytes(fd_, buffer, padded, offset_)) {
+        throw_spdlog_ex("Failed writing to file " + os::filename_to_str(filename_), errno);
+    }
+    // keep the last partial block, to be rewritten with what follows it
+    const size_t whole_blocks = filled_ / alignment * alignment;
+    if (whole_blocks > 0) {
+        std::memmove(buffer, buffer + whole_blocks, filled_ - whole_blocks);
+        offset_ += whole_blocks;
+        filled_ -= whole_blocks;
+    }
+}
+
+void direct_writer::submit_() {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        // the other buffer is free once its write is done
+        wait_idle_(lock);
+        pending_ = buffers_[active_].get();
+        pending_offset_ = offset_;
+    }
+    cv_.notify_all();
+    active_ ^= 1;
+    offset_ += buffer_size_;
+    filled_ = 0;
+}
+
+void direct_writer::wait_idle_(std::unique_lock<std::mutex> &lock) {
+    cv_.wait(lock, [this] { return pending_ == nullptr; });
+    if (error_ != 0) {
+        throw_spdlog_ex("Failed writing to file " + os::filename_to_str(filename_), std::exchange(error_, 0));
+    }
+}
+
+void direct_writer::run_() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        cv_.wait(lock, [this] { return stop_ || pending_ != nullptr; });
+        if (pending_ == nullptr) {
+            return;
+        }
+        const char *data = pending_;
+        const size_t offset = pending_offset_;
+        lock.unlock();
+        const bool ok = os::pwrite_bytes(fd_, data, buffer_size_, offset);
+        const int error = errno;
+        lock.lock();
+        if (!ok && error_ == 0) {
+            error_ = error != 0 ? error : EIO;
+        }
+        pending_ = nullptr;
+        cv_.notify_all();
+    }
+}
+
+}  // namespace details
+}  // namespace spdlog
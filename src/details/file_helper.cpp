@@ -5,7 +5,9 @@
 
 #include <cerrno>
 #include <cstdio>
+#include <cstring>
 #include <filesystem>
+#include <new>
 #include <utility>
 
 #include "spdlog/common.h"
@@ -14,48 +16,188 @@
 namespace spdlog {
 namespace details {
 
-file_helper::file_helper(file_event_handlers event_handlers)
-    : event_handlers_(std::move(event_handlers)) {}
+// the write buffer is page aligned so it can be submitted as is to unbuffered (e.g. O_DIRECT) files
+static constexpr std::align_val_t write_buffer_alignment{4096};
+
+// page_cache_mode::bypass staging buffers without write_buffer_size, page_cache_mode::drop interval
+static constexpr size_t cache_chunk_size = 1024 * 1024;
+
+file_helper::file_helper(file_event_handlers event_handlers, size_t write_buffer_size)
+    : event_handlers_(std::move(event_handlers)),
+      write_buffer_size_{write_buffer_size} {
+    if (write_buffer_size_ > 0) {
+        write_buffer_.reset(static_cast<char *>(::operator new(write_buffer_size_, write_buffer_alignment)));
+    }
+}
+
+void file_helper::buffer_deleter::operator()(char *p) const noexcept { ::operator delete(p, write_buffer_alignment); }
 
 file_helper::~file_helper() { close(); }
 
 void file_helper::open(const filename_t &fname, bool truncate) {
     close();
     filename_ = fname;
+    fd_ = prepare(fname, truncate);
+    overwrite_ = preallocate_ > 0;
+    on_open_();
+}
 
+std::FILE *file_helper::prepare(const filename_t &fname, bool truncate) const {
     const auto *mode = SPDLOG_FILENAME_T("ab");
     const auto *trunc_mode = SPDLOG_FILENAME_T("wb");
 
     if (event_handlers_.before_open) {
-        event_handlers_.before_open(filename_);
+        event_handlers_.before_open(fname);
     }
 
     // create containing folder if not exists already.
     os::create_dir(os::dir_name(fname));
 
     for (int tries = 0; tries < open_tries_; ++tries) {
-        if (truncate) {
-            // Truncate by opening-and-closing a tmp file in "wb" mode, always
-            // opening the actual log-we-write-to in "ab" mode, since that
-            // interacts more politely with eternal processes that might
-            // rotate/truncate the file underneath us.
-            std::FILE *tmp = nullptr;
-            if (os::fopen_s(&tmp, fname, trunc_mode)) {
-                continue;
+        std::FILE *fp = nullptr;
+        if (preallocate_ > 0) {
+            fp = open_preallocated_(fname, truncate);
+        } else {
+            if (truncate) {
+                // Truncate by opening-and-closing a tmp file in "wb" mode, always
+                // opening the actual log-we-write-to in "ab" mode, since that
+                // interacts more politely with eternal processes that might
+                // rotate/truncate the file underneath us.
+                std::FILE *tmp = nullptr;
+                if (os::fopen_s(&tmp, fname, trunc_mode)) {
+                    continue;
+                }
+                std::fclose(tmp);
             }
-            std::fclose(tmp);
+            os::fopen_s(&fp, fname, mode);
         }
-        if (!os::fopen_s(&fd_, fname, mode)) {
+        if (fp != nullptr) {
             if (event_handlers_.after_open) {
-                event_handlers_.after_open(filename_, fd_);
+                event_handlers_.after_open(fname, fp);
+                // make sure whatever the handler wrote precedes our buffered writes
+                if (write_buffer_) {
+                    std::fflush(fp);
+                }
             }
-            return;
+            return fp;
         }
 
         details::os::sleep_for_millis(open_interval_);
     }
 
-    throw_spdlog_ex("Failed opening file " + os::filename_to_str(filename_) + " for writing", errno);
+    throw_spdlog_ex("Failed opening file " + os::filename_to_str(fname) + " for writing", errno);
+}
+
+std::FILE *file_helper::open_preallocated_(const filename_t &fname, bool truncate) const {
+    // "r+b" doesn't create the file, and unlike "wb" it keeps the allocated blocks
+    std::FILE *fp = nullptr;
+    if (!os::path_exists(fname)) {
+        if (os::fopen_s(&fp, fname, SPDLOG_FILENAME_T("ab"))) {
+            return nullptr;
+        }
+        std::fclose(fp);
+    }
+    if (os::fopen_s(&fp, fname, SPDLOG_FILENAME_T("r+b"))) {
+        return nullptr;
+    }
+    const size_t position = truncate ? 0 : os::filesize(fp);
+    os::preallocate(fp, preallocate_);  // best effort - without it the file just grows as usual
+    if (!os::seek(fp, position)) {
+        std::fclose(fp);
+        return nullptr;
+    }
+    return fp;
+}
+
+void file_helper::adopt(std::FILE *fp, const filename_t &fname) {
+    close();
+    filename_ = fname;
+    fd_ = fp;
+    overwrite_ = preallocate_ > 0;
+    on_open_();
+}
+
+void file_helper::on_open_() {
+    // the only stat of the file until resync(). count whatever the open handler wrote.
+    std::fflush(fd_);
+    written_ = overwrite_ ? os::file_offset(fd_) : os::filesize(fd_);
+    if (syncer_) {
+        syncer_->set_file(os::dup_fd(fd_));
+        last_sync_ = std::chrono::steady_clock::now();
+    }
+    start_cache_mode_();
+}
+
+void file_helper::start_cache_mode_() {
+    drop_mark_ = written_;
+    writeback_offset_ = dropped_offset_ = written_;
+    // preallocated files are written at a position of the FILE*
+    if (cache_mode_ != page_cache_mode::bypass || overwrite_ || gzip_) {
+        return;
+    }
+    direct_fd_ = os::open_direct(filename_);
+    if (direct_fd_ < 0) {
+        return;  // not supported - page_cache_mode::drop
+    }
+    try {
+        const size_t buffer_size = write_buffer_size_ > 0 ? write_buffer_size_ : cache_chunk_size;
+        direct_ = std::make_unique<direct_writer>(direct_fd_, written_, buffer_size, filename_);
+    } catch (const spdlog_ex &) {
+        os::close_fd(direct_fd_);  // e.g. direct reads are not supported
+        direct_fd_ = -1;
+    }
+}
+
+void file_helper::stop_cache_mode_() {
+    if (direct_) {
+        // errors are ignored since close() is called by the destructor
+        try {
+            flush_direct_();
+        } catch (...) {
+        }
+        direct_.reset();
+        os::close_fd(direct_fd_);
+        direct_fd_ = -1;
+    } else if (cache_mode_ != page_cache_mode::keep) {
+        std::fflush(fd_);
+        os::start_writeback(fd_, writeback_offset_, 0);
+        os::drop_cache(fd_, dropped_offset_, 0);
+    }
+}
+
+void file_helper::set_page_cache_mode(page_cache_mode mode) {
+    if (mode == page_cache_mode::bypass && gzip_) {
+        throw_spdlog_ex("file_helper: page_cache_mode::bypass is not supported with live compression");
+    }
+    if (fd_ != nullptr) {
+        stop_cache_mode_();
+    }
+    cache_mode_ = mode;
+    if (fd_ != nullptr) {
+        start_cache_mode_();
+    }
+}
+
+void file_helper::flush_direct_() const {
+    direct_->flush();
+    if (written_ % direct_writer::alignment != 0 && !os::truncate(fd_, written_)) {
+        throw_spdlog_ex("Failed truncating file " + os::filename_to_str(filename_), errno);
+    }
+}
+
+void file_helper::drop_written_() const {
+    drop_mark_ = written_;
+    flush_buffer_();
+    if (gzip_) {
+        gzip_->flush(fd_);
+    }
+    std::fflush(fd_);
+    const size_t offset = os::file_offset(fd_);
+    // the data whose writeback was started last time is likely on the disk by now
+    os::drop_cache(fd_, dropped_offset_, writeback_offset_ - dropped_offset_);
+    dropped_offset_ = writeback_offset_;
+    os::start_writeback(fd_, writeback_offset_, offset - writeback_offset_);
+    writeback_offset_ = offset;
 }
 
 void file_helper::reopen(bool truncate) {
@@ -66,12 +208,27 @@ void file_helper::reopen(bool truncate) {
 }
 
 void file_helper::flush() const {
+    if (direct_) {
+        flush_direct_();
+    }
+    flush_buffer_();
+    if (gzip_) {
+        gzip_->flush(fd_);
+    }
     if (std::fflush(fd_) != 0) {
         throw_spdlog_ex("Failed flush to file " + os::filename_to_str(filename_), errno);
     }
+    // let the periodic sync pick up what was just flushed
+    if (syncer_ && unsynced_bytes_ > 0) {
+        syncer_->mark_dirty();
+    }
 }
 
 void file_helper::sync() const {
+    if (direct_) {
+        flush_direct_();
+    }
+    flush_buffer_();
     if (!os::fsync(fd_)) {
         throw_spdlog_ex("Failed to fsync file " + os::filename_to_str(filename_), errno);
     }
@@ -79,13 +236,47 @@ void file_helper::sync() const {
 
 void file_helper::close() {
     if (fd_ != nullptr) {
+        // write what's left in the buffer. errors are ignored since close() is called by the destructor.
+        if (buffered_ > 0) {
+            const string_view_t pending{write_buffer_.get(), buffered_};
+            os::write_spans(&pending, 1, fd_);
+            buffered_ = 0;
+        }
+        if (gzip_) {
+            try {
+                gzip_->finish(fd_);
+            } catch (...) {
+            }
+        }
+
+        stop_cache_mode_();
+
         if (event_handlers_.before_close) {
             event_handlers_.before_close(filename_, fd_);
         }
 
+        // cut off the preallocated space that was not written
+        if (overwrite_) {
+            std::fflush(fd_);
+            try {
+                os::truncate(fd_, os::file_offset(fd_));
+            } catch (...) {
+            }
+            overwrite_ = false;
+        }
+
         std::fclose(fd_);
         fd_ = nullptr;
 
+        // the syncer syncs the closed file on its own descriptor if there is unsynced data
+        if (syncer_) {
+            if (unsynced_bytes_ > 0) {
+                syncer_->mark_dirty();
+                unsynced_bytes_ = 0;
+            }
+            syncer_->set_file(-1);
+        }
+
         if (event_handlers_.after_close) {
             event_handlers_.after_close(filename_);
         }
@@ -94,21 +285,163 @@ void file_helper::close() {
 
 void file_helper::write(const memory_buf_t &buf) const {
     if (fd_ == nullptr) return;
+    if (write_buffer_ || gzip_ || direct_) {
+        const string_view_t span{buf.data(), buf.size()};
+        write(&span, 1);
+        return;
+    }
+    if (cache_mode_ != page_cache_mode::keep && written_ - drop_mark_ >= cache_chunk_size) {
+        drop_written_();
+    }
     const size_t msg_size = buf.size();
     const auto *data = buf.data();
     if (!os::fwrite_bytes(data, msg_size, fd_)) {
         throw_spdlog_ex("Failed writing to file " + os::filename_to_str(filename_), errno);
     }
+    unsynced_bytes_ += msg_size;
+    written_ += msg_size;
+}
+
+void file_helper::write(const string_view_t *spans, size_t count) const {
+    if (fd_ == nullptr) return;
+    if (direct_) {
+        for (size_t i = 0; i < count; ++i) {
+            direct_->write(spans[i].data(), spans[i].size());
+            unsynced_bytes_ += spans[i].size();
+            written_ += spans[i].size();
+        }
+        return;
+    }
+    if (cache_mode_ != page_cache_mode::keep && written_ - drop_mark_ >= cache_chunk_size) {
+        drop_written_();
+    }
+    if (gzip_) {
+        // the compressed output goes through the FILE* buffer
+        for (size_t i = 0; i < count; ++i) {
+            gzip_->write(spans[i].data(), spans[i].size(), fd_);
+            unsynced_bytes_ += spans[i].size();
+            written_ += spans[i].size();
+        }
+        return;
+    }
+    if (!write_buffer_) {
+        for (size_t i = 0; i < count; ++i) {
+            if (!os::fwrite_bytes(spans[i].data(), spans[i].size(), fd_)) {
+                throw_spdlog_ex("Failed writing to file " + os::filename_to_str(filename_), errno);
+            }
+            unsynced_bytes_ += spans[i].size();
+            written_ += spans[i].size();
+        }
+        return;
+    }
+
+    size_t total_size = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total_size += spans[i].size();
+    }
+    unsynced_bytes_ += total_size;
+    written_ += total_size;
+    if (buffered_ + total_size > write_buffer_size_) {
+        flush_buffer_();
+        // too large for the buffer - write directly
+        if (total_size >= write_buffer_size_) {
+            if (!os::write_spans(spans, count, fd_)) {
+                throw_spdlog_ex("Failed writing to file " + os::filename_to_str(filename_), errno);
+            }
+            return;
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (spans[i].size() > 0) {
+            std::memcpy(write_buffer_.get() + buffered_, spans[i].data(), spans[i].size());
+            buffered_ += spans[i].size();
+        }
+    }
 }
 
 size_t file_helper::size() const {
     if (fd_ == nullptr) {
         throw_spdlog_ex("Cannot use size() on closed file " + os::filename_to_str(filename_));
     }
-    return os::filesize(fd_);
+    return written_;
+}
+
+size_t file_helper::resync() {
+    if (fd_ == nullptr) {
+        throw_spdlog_ex("Cannot use resync() on closed file " + os::filename_to_str(filename_));
+    }
+    flush();
+    // the file size of a preallocated file is not the written size
+    written_ = overwrite_ ? os::file_offset(fd_) : os::filesize(fd_);
+    if (direct_) {
+        const size_t buffer_size = write_buffer_size_ > 0 ? write_buffer_size_ : cache_chunk_size;
+        direct_ = std::make_unique<direct_writer>(direct_fd_, written_, buffer_size, filename_);
+    }
+    return written_;
 }
 
 const filename_t &file_helper::filename() const { return filename_; }
 
+void file_helper::set_compression(int level) {
+    if (level > 0 && cache_mode_ == page_cache_mode::bypass) {
+        throw_spdlog_ex("file_helper: live compression is not supported with page_cache_mode::bypass");
+    }
+    if (gzip_ && fd_ != nullptr) {
+        gzip_->finish(fd_);
+    }
+    gzip_.reset();
+    if (level > 0) {
+        flush_buffer_();
+        gzip_ = std::make_unique<gzip_writer>(level);
+    }
+}
+
+void file_helper::set_sync_policy(const file_sync_policy &policy) {
+    sync_policy_ = policy;
+    syncer_.reset();
+    unsynced_bytes_ = 0;
+    if (!policy.enabled()) {
+        return;
+    }
+    syncer_ = std::make_unique<file_syncer>(policy.every);
+    if (fd_ != nullptr) {
+        syncer_->set_file(os::dup_fd(fd_));
+    }
+    last_sync_ = std::chrono::steady_clock::now();
+}
+
+void file_helper::sync_by_policy(level msg_level) const {
+    if (!syncer_ || fd_ == nullptr || unsynced_bytes_ == 0) {
+        return;
+    }
+    bool due = (sync_policy_.on_level != level::off && msg_level >= sync_policy_.on_level) ||
+               (sync_policy_.every_bytes > 0 && unsynced_bytes_ >= sync_policy_.every_bytes);
+    if (!due && sync_policy_.every.count() > 0) {
+        due = std::chrono::steady_clock::now() - last_sync_ >= sync_policy_.every;
+    }
+    if (!due) {
+        return;
+    }
+    // the syncer can only sync what reached the kernel. this runs on the logging thread only, so nothing
+    // flushes a sink's buffer after its last message - see file_sync_policy::every.
+    flush();
+    syncer_->request();
+    unsynced_bytes_ = 0;
+    if (sync_policy_.every.count() > 0) {
+        last_sync_ = std::chrono::steady_clock::now();
+    }
+}
+
+void file_helper::flush_buffer_() const {
+    if (buffered_ == 0) {
+        return;
+    }
+    const string_view_t pending{write_buffer_.get(), buffered_};
+    buffered_ = 0;
+    if (!os::write_spans(&pending, 1, fd_)) {
+        throw_spdlog_ex("Failed writing to file " + os::filename_to_str(filename_), errno);
+    }
+}
+
 }  // namespace details
 }  // namespace spdlog
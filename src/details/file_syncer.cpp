@@ -0,0 +1,104 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "spdlog/details/file_syncer.h"
+
+#include "spdlog/details/os.h"
+
+namespace spdlog {
+namespace details {
+
+file_syncer::file_syncer(std::chrono::milliseconds interval)
+    : interval_{interval},
+      thread_{[this] { run_(); }} {}
+
+file_syncer::~file_syncer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+}
+
+void file_syncer::set_file(int fd) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (fd_ >= 0) {
+            retired_.emplace_back(fd_, dirty_);
+        }
+        fd_ = fd;
+        dirty_ = false;
+        requested_ = false;
+    }
+    cv_.notify_one();
+}
+
+void file_syncer::mark_dirty() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dirty_ = true;
+}
+
+void file_syncer::request() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dirty_ = true;
+        requested_ = true;
+    }
+    cv_.notify_one();
+}
+
+void file_syncer::run_() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        auto has_work = [this] { return stop_ || requested_ || !retired_.empty(); };
+        bool periodic = false;
+        if (interval_.count() > 0) {
+            periodic = !cv_.wait_for(lock, interval_, has_work);
+        } else {
+            cv_.wait(lock, has_work);
+        }
+
+        auto retired = std::move(retired_);
+        retired_.clear();
+        const bool stop = stop_;
+        const int fd = fd_;
+        const bool sync_current = fd >= 0 && dirty_ && (requested_ || periodic || stop);
+        if (sync_current) {
+            dirty_ = false;
+            requested_ = false;
+        }
+        if (stop) {
+            fd_ = -1;
+        }
+
+        // sync without holding the lock so that the logging thread never waits for the disk.
+        // fd stays valid since only this thread closes the descriptors it was given.
+        lock.unlock();
+        for (const auto &file : retired) {
+            if (file.second) {
+                sync_fd_(file.first);
+            }
+            os::close_fd(file.first);
+        }
+        if (sync_current) {
+            sync_fd_(fd);
+        }
+        if (stop) {
+            if (fd >= 0) {
+                os::close_fd(fd);
+            }
+            return;
+        }
+        lock.lock();
+    }
+}
+
+// errors are ignored - the data stays in the page cache and is written by the os eventually
+void file_syncer::sync_fd_(int fd) {
+    os::fdatasync(fd);
+    sync_counter_.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace details
+}  // namespace spdlog
@@ -0,0 +1,43 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "spdlog/details/format_buffer.h"
+
+namespace spdlog {
+namespace details {
+
+#if !defined(SPDLOG_NO_TLS) && !defined(SPDLOG_MEMORY_RESOURCE)
+namespace {
+struct thread_buffer {
+    memory_buf_t buf;
+    bool in_use = false;
+};
+thread_local thread_buffer current;
+}  // namespace
+
+format_buffer::format_buffer() noexcept
+    : buf_{&local_} {
+    if (!current.in_use) {
+        current.in_use = true;
+        current.buf.clear();
+        buf_ = &current.buf;
+    }
+}
+
+format_buffer::~format_buffer() {
+    if (buf_ != &local_) {
+        if (current.buf.capacity() > max_kept_capacity) {
+            current.buf = memory_buf_t{};
+        }
+        current.in_use = false;
+    }
+}
+#else
+format_buffer::format_buffer() noexcept
+    : buf_{&local_} {}
+
+format_buffer::~format_buffer() = default;
+#endif
+
+}  // namespace details
+}  // namespace spdlog
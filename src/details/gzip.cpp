@@ -0,0 +1,141 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "spdlog/details/gzip.h"
+
+#include <cerrno>
+#include <climits>
+
+#include "spdlog/details/os.h"
+
+#ifdef SPDLOG_ZLIB
+    #include <zlib.h>
+#endif
+
+namespace spdlog {
+namespace details {
+
+#ifdef SPDLOG_ZLIB
+
+static constexpr size_t gzip_chunk_size = 64 * 1024;
+static constexpr int gzip_window_bits = 15 + 16;  // +16: gzip header and trailer instead of zlib's
+
+struct gzip_writer::impl {
+    z_stream stream{};
+    bool started = false;  // a gzip member was started and not finished yet
+    unsigned char out[gzip_chunk_size];
+
+    // feed input (if any) to deflate and write the output to fp until deflate has nothing more to say
+    void deflate_to(std::FILE *fp, int flush) {
+        int rv;
+        do {
+            stream.next_out = out;
+            stream.avail_out = static_cast<uInt>(sizeof(out));
+            rv = ::deflate(&stream, flush);
+            if (rv == Z_STREAM_ERROR) {
+                throw_spdlog_ex("gzip: deflate failed");
+            }
+            const size_t n = sizeof(out) - stream.avail_out;
+            if (n > 0 && !os::fwrite_bytes(out, n, fp)) {
+                throw_spdlog_ex("gzip: failed writing compressed data", errno);
+            }
+        } while (stream.avail_out == 0 || (flush == Z_FINISH && rv != Z_STREAM_END));
+    }
+};
+
+gzip_writer::gzip_writer(int level)
+    : impl_{std::make_unique<impl>()} {
+    if (::deflateInit2(&impl_->stream, level, Z_DEFLATED, gzip_window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw_spdlog_ex("gzip: deflateInit2 failed");
+    }
+}
+
+gzip_writer::~gzip_writer() { ::deflateEnd(&impl_->stream); }
+
+void gzip_writer::write(const char *data, size_t size, std::FILE *fp) {
+    impl_->started = true;
+    while (size > 0) {
+        const auto n = static_cast<uInt>(size < UINT_MAX ? size : UINT_MAX);
+        impl_->stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        impl_->stream.avail_in = n;
+        impl_->deflate_to(fp, Z_NO_FLUSH);
+        data += n;
+        size -= n;
+    }
+}
+
+void gzip_writer::flush(std::FILE *fp) {
+    if (impl_->started) {
+        impl_->deflate_to(fp, Z_SYNC_FLUSH);
+    }
+}
+
+void gzip_writer::finish(std::FILE *fp) {
+    if (!impl_->started) {
+        return;
+    }
+    impl_->started = false;
+    impl_->deflate_to(fp, Z_FINISH);
+    ::deflateReset(&impl_->stream);
+}
+
+void gzip_file(const filename_t &src, const filename_t &dst, int level) {
+    std::FILE *in = nullptr;
+    if (os::fopen_s(&in, src, SPDLOG_FILENAME_T("rb"))) {
+        throw_spdlog_ex("gzip: failed opening " + os::filename_to_str(src), errno);
+    }
+    std::FILE *out = nullptr;
+    if (os::fopen_s(&out, dst, SPDLOG_FILENAME_T("wb"))) {
+        std::fclose(in);
+        throw_spdlog_ex("gzip: failed opening " + os::filename_to_str(dst), errno);
+    }
+    try {
+        gzip_writer writer(level);
+        char buf[gzip_chunk_size];
+        size_t n;
+        while ((n = std::fread(buf, 1, sizeof(buf), in)) > 0) {
+            writer.write(buf, n, out);
+        }
+        if (std::ferror(in)) {
+            throw_spdlog_ex("gzip: failed reading " + os::filename_to_str(src), errno);
+        }
+        writer.finish(out);
+    } catch (...) {
+        std::fclose(in);
+        std::fclose(out);
+        os::remove_if_exists(dst);
+        throw;
+    }
+    std::fclose(in);
+    if (std::fclose(out) != 0) {
+        os::remove_if_exists(dst);
+        throw_spdlog_ex("gzip: failed writing " + os::filename_to_str(dst), errno);
+    }
+}
+
+bool gzip_available() noexcept { return true; }
+
+#else  // !SPDLOG_ZLIB
+
+struct gzip_writer::impl {};
+
+gzip_writer::gzip_writer(int) { throw_spdlog_ex("gzip compression is not available - spdlog was built without SPDLOG_ZLIB"); }
+
+gzip_writer::~gzip_writer() = default;
+
+void gzip_writer::write(const char *, size_t, std::FILE *) {}
+
+void gzip_writer::flush(std::FILE *) {}
+
+void gzip_writer::finish(std::FILE *) {}
+
+void gzip_file(const filename_t &, const filename_t &, int) {
+    throw_spdlog_ex("gzip compression is not available - spdlog was built without SPDLOG_ZLIB");
+}
+
+bool gzip_available() noexcept { return false; }
+
+#endif
+
+}  // namespace details
+}  // namespace spdlog
@@ -4,6 +4,7 @@
 #include "spdlog/details/log_msg.h"
 
 #include "spdlog/details/os.h"
+#include "spdlog/mdc.h"
 
 namespace spdlog {
 namespace details {
@@ -22,7 +23,8 @@ log_msg::log_msg(spdlog::log_clock::time_point log_time,
       thread_id(os::thread_id()),
 #endif
       source(loc),
-      payload(msg) {
+      payload(msg),
+      context(mdc::current()) {
 }
 
 log_msg::log_msg(spdlog::source_loc loc, string_view_t a_logger_name, spdlog::level lvl, spdlog::string_view_t msg)
@@ -3,6 +3,10 @@
 
 #include "spdlog/details/log_msg_buffer.h"
 
+#include <algorithm>
+
+#include "spdlog/mdc.h"
+
 namespace spdlog {
 namespace details {
 
@@ -11,22 +15,28 @@ namespace details {
 // are compiler generated const chars* (__FILE__, __LINE__, __FUNCTION__)
 // if you pass custom strings to source location, make sure they outlive the log_msg_buffer
 log_msg_buffer::log_msg_buffer(const log_msg &orig_msg)
-    : log_msg{orig_msg} {
+    : log_msg{orig_msg},
+      context_holder_{context != nullptr ? context->shared_from_this() : nullptr} {
     buffer.append(logger_name);
     buffer.append(payload);
+    copy_fields_();
     update_string_views();
 }
 
 log_msg_buffer::log_msg_buffer(const log_msg_buffer &other)
-    : log_msg{other} {
+    : log_msg{other},
+      context_holder_{other.context_holder_} {
     buffer.append(logger_name);
     buffer.append(payload);
+    copy_fields_();
     update_string_views();
 }
 
 log_msg_buffer::log_msg_buffer(log_msg_buffer &&other) noexcept
     : log_msg{other},
-      buffer{std::move(other.buffer)} {
+      buffer{std::move(other.buffer)},
+      fields_buf_{other.fields_buf_},
+      context_holder_{std::move(other.context_holder_)} {
     update_string_views();
 }
 
@@ -34,6 +44,8 @@ log_msg_buffer &log_msg_buffer::operator=(const log_msg_buffer &other) {
     log_msg::operator=(other);
     buffer.clear();
     buffer.append(other.buffer.data(), other.buffer.data() + other.buffer.size());
+    fields_buf_ = other.fields_buf_;
+    context_holder_ = other.context_holder_;
     update_string_views();
     return *this;
 }
@@ -41,13 +53,48 @@ log_msg_buffer &log_msg_buffer::operator=(const log_msg_buffer &other) {
 log_msg_buffer &log_msg_buffer::operator=(log_msg_buffer &&other) noexcept {
     log_msg::operator=(other);
     buffer = std::move(other.buffer);
+    fields_buf_ = other.fields_buf_;
+    context_holder_ = std::move(other.context_holder_);
     update_string_views();
     return *this;
 }
 
+void log_msg_buffer::assign(const log_msg &orig_msg) {
+    log_msg::operator=(orig_msg);
+    context_holder_ = context != nullptr ? context->shared_from_this() : nullptr;
+    buffer.clear();
+    buffer.append(logger_name);
+    buffer.append(payload);
+    copy_fields_();
+    update_string_views();
+}
+
+// copy the fields to the inline array and append their strings to the buffer.
+// fields beyond SPDLOG_MAX_LOG_FIELDS are dropped.
+void log_msg_buffer::copy_fields_() {
+    fields_count = std::min(fields_count, fields_buf_.size());
+    for (size_t i = 0; i < fields_count; ++i) {
+        fields_buf_[i] = fields[i];
+        buffer.append(fields_buf_[i].key);
+        buffer.append(fields_buf_[i].string_value());
+    }
+}
+
 void log_msg_buffer::update_string_views() {
     logger_name = string_view_t{buffer.data(), logger_name.size()};
     payload = string_view_t{buffer.data() + logger_name.size(), payload.size()};
+
+    auto *pos = buffer.data() + logger_name.size() + payload.size();
+    for (size_t i = 0; i < fields_count; ++i) {
+        auto &field = fields_buf_[i];
+        field.key = string_view_t{pos, field.key.size()};
+        pos += field.key.size();
+        if (field.type == log_field::value_type::string) {
+            field.value.str_value.data = pos;
+            pos += field.value.str_value.size;
+        }
+    }
+    fields = fields_count > 0 ? fields_buf_.data() : nullptr;
 }
 
 }  // namespace details
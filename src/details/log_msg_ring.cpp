@@ -0,0 +1,192 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "spdlog/details/log_msg_ring.h"
+
+#include <cstring>
+#include <new>
+
+#include "spdlog/mdc.h"
+
+namespace spdlog {
+namespace details {
+
+// Arena layout: records are stored back to back. Each record starts with a trivial prefix
+// (total record size and padding flag) followed by the header, the key/value fields array and
+// the string bytes (logger name, payload, field keys and string values).
+// When a record doesn't fit at the end of the arena, the rest of the arena is marked as padding
+// (or left as is if too small to hold a prefix) and the record is written at the beginning.
+
+namespace {
+struct record_prefix {
+    size_t record_size;  // total bytes of the record, including the prefix
+    bool padding;        // filler up to the end of the arena
+};
+
+constexpr size_t record_align = alignof(std::max_align_t);
+
+constexpr size_t align_up(size_t n) noexcept { return (n + record_align - 1) & ~(record_align - 1); }
+
+constexpr size_t prefix_size = align_up(sizeof(record_prefix));
+}  // namespace
+
+struct log_msg_ring::record_header {
+    level log_level{level::off};
+    log_clock::time_point time;
+    size_t thread_id{0};
+    source_loc source;
+    std::shared_ptr<const mdc_data> context;
+    size_t logger_name_size{0};
+    size_t payload_size{0};
+    size_t fields_count{0};
+};
+
+log_msg_ring::log_msg_ring(size_t max_items, size_t arena_size)
+    : capacity_{arena_size & ~(record_align - 1)},
+      max_items_{max_items} {
+    if (capacity_ > 0) {
+        arena_.reset(new unsigned char[capacity_]);
+    }
+}
+
+log_msg_ring::~log_msg_ring() {
+    while (!empty()) {
+        pop_front();
+    }
+}
+
+void log_msg_ring::push_back(const log_msg &msg) {
+    if (max_items_ == 0 || capacity_ == 0) {
+        return;
+    }
+    const size_t record_size = record_size_(msg);
+    if (record_size > capacity_) {
+        ++overrun_counter_;
+        return;
+    }
+    while (count_ >= max_items_) {
+        pop_front();
+        ++overrun_counter_;
+    }
+
+    // find room at tail_, overwriting the oldest records as needed
+    for (;;) {
+        if (count_ == 0) {
+            head_ = tail_ = 0;
+        }
+        if (count_ == 0 || tail_ > head_) {
+            // free space is [tail_, capacity_) and [0, head_)
+            if (capacity_ - tail_ >= record_size) {
+                break;
+            }
+            if (capacity_ - tail_ >= prefix_size) {
+                new (arena_.get() + tail_) record_prefix{capacity_ - tail_, true};
+            }
+            tail_ = 0;
+        } else {
+            // free space is [tail_, head_)
+            if (head_ - tail_ >= record_size) {
+                break;
+            }
+            pop_front();
+            ++overrun_counter_;
+        }
+    }
+
+    write_record_(tail_, record_size, msg);
+    tail_ += record_size;
+    ++count_;
+}
+
+log_msg log_msg_ring::front() const {
+    const auto *header = header_at_(head_);
+    const auto *fields = reinterpret_cast<const log_field *>(header + 1);
+    const auto *chars = reinterpret_cast<const char *>(fields + header->fields_count);
+
+    log_msg msg;
+    msg.logger_name = string_view_t{chars, header->logger_name_size};
+    msg.payload = string_view_t{chars + header->logger_name_size, header->payload_size};
+    msg.log_level = header->log_level;
+    msg.time = header->time;
+    msg.thread_id = header->thread_id;
+    msg.source = header->source;
+    msg.fields = header->fields_count > 0 ? fields : nullptr;
+    msg.fields_count = header->fields_count;
+    msg.context = header->context.get();
+    return msg;
+}
+
+void log_msg_ring::pop_front() {
+    const auto *prefix = reinterpret_cast<const record_prefix *>(arena_.get() + head_);
+    header_at_(head_)->~record_header();
+    head_ += prefix->record_size;
+    --count_;
+    normalize_head_();
+}
+
+log_msg_ring::record_header *log_msg_ring::header_at_(size_t offset) const noexcept {
+    return reinterpret_cast<record_header *>(arena_.get() + offset + prefix_size);
+}
+
+size_t log_msg_ring::record_size_(const log_msg &msg) const noexcept {
+    size_t size = prefix_size + sizeof(record_header) + msg.fields_count * sizeof(log_field);
+    size += msg.logger_name.size() + msg.payload.size();
+    for (size_t i = 0; i < msg.fields_count; ++i) {
+        size += msg.fields[i].key.size() + msg.fields[i].string_value().size();
+    }
+    return align_up(size);
+}
+
+// serialize the message at the given offset. field keys and string values are re-pointed
+// into the arena, which never moves.
+void log_msg_ring::write_record_(size_t offset, size_t record_size, const log_msg &msg) {
+    unsigned char *base = arena_.get() + offset;
+    new (base) record_prefix{record_size, false};
+
+    auto *header = new (base + prefix_size) record_header{};
+    header->log_level = msg.log_level;
+    header->time = msg.time;
+    header->thread_id = msg.thread_id;
+    header->source = msg.source;
+    header->context = msg.context != nullptr ? msg.context->shared_from_this() : nullptr;
+    header->logger_name_size = msg.logger_name.size();
+    header->payload_size = msg.payload.size();
+    header->fields_count = msg.fields_count;
+
+    auto *fields = reinterpret_cast<log_field *>(header + 1);
+    auto *chars = reinterpret_cast<char *>(fields + msg.fields_count);
+    auto append = [&chars](string_view_t sv) {
+        string_view_t copied{chars, sv.size()};
+        if (sv.size() > 0) {
+            std::memcpy(chars, sv.data(), sv.size());
+        }
+        chars += sv.size();
+        return copied;
+    };
+
+    append(msg.logger_name);
+    append(msg.payload);
+    for (size_t i = 0; i < msg.fields_count; ++i) {
+        log_field field = msg.fields[i];
+        field.key = append(field.key);
+        if (field.type == log_field::value_type::string) {
+            const auto value = append(field.string_value());
+            field.value.str_value = {value.data(), value.size()};
+        }
+        new (fields + i) log_field(field);
+    }
+}
+
+// skip padding at the end of the arena so head_ always points to a message record
+void log_msg_ring::normalize_head_() noexcept {
+    if (count_ == 0) {
+        head_ = tail_ = 0;
+        return;
+    }
+    if (capacity_ - head_ < prefix_size || reinterpret_cast<const record_prefix *>(arena_.get() + head_)->padding) {
+        head_ = 0;
+    }
+}
+
+}  // namespace details
+}  // namespace spdlog
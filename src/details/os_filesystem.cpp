@@ -33,6 +33,24 @@ bool rename(const filename_t &filename1, const filename_t &filename2) noexcept {
 // Return true if path exists (file or directory)
 bool path_exists(const filename_t &filename) noexcept { return std::filesystem::exists(filename); }
 
+// Create the link under a temporary name and rename it over the old one, so the link never disappears
+bool create_symlink(const filename_t &target, const filename_t &link) noexcept {
+    std::error_code ec;
+    filename_t tmp = link;
+    tmp += SPDLOG_FILENAME_T(".tmp");
+    std::filesystem::remove(tmp, ec);
+    std::filesystem::create_symlink(target, tmp, ec);
+    if (ec) {
+        return false;
+    }
+    std::filesystem::rename(tmp, link, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
 // Return directory name from given path or empty string
 // "abc/file" => "abc"
 // "abc/" => "abc"
@@ -3,15 +3,19 @@
 
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <algorithm>
 #include <array>
+#include <cerrno>
 #include <chrono>
+#include <climits>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
+#include <limits>
 #include <string>
 #include <thread>
 
@@ -84,8 +88,13 @@ std::tm gmtime() noexcept {
 // fopen_s on non windows for writing
 bool fopen_s(FILE **fp, const filename_t &filename, const filename_t &mode) {
 #if defined(SPDLOG_PREVENT_CHILD_FD)
-    const int mode_flag = mode == SPDLOG_FILENAME_T("ab") ? O_APPEND : O_TRUNC;
-    const int fd = ::open((filename.c_str()), O_CREAT | O_WRONLY | O_CLOEXEC | mode_flag, mode_t(0644));
+    int flags = O_CREAT | O_WRONLY | O_CLOEXEC | O_TRUNC;
+    if (mode == SPDLOG_FILENAME_T("ab")) {
+        flags = O_CREAT | O_WRONLY | O_CLOEXEC | O_APPEND;
+    } else if (mode == SPDLOG_FILENAME_T("r+b")) {
+        flags = O_RDWR | O_CLOEXEC;
+    }
+    const int fd = ::open((filename.c_str()), flags, mode_t(0644));
     if (fd == -1) {
         return true;
     }
@@ -275,6 +284,117 @@ std::string getenv(const char *field) {
 // Return true on success
 bool fsync(FILE *fp) { return ::fsync(fileno(fp)) == 0; }
 
+int dup_fd(FILE *fp) noexcept { return ::fcntl(fileno(fp), F_DUPFD_CLOEXEC, 0); }
+
+void close_fd(int fd) noexcept { ::close(fd); }
+
+bool fdatasync(int fd) noexcept {
+#if defined(__linux__) || defined(__FreeBSD__) || defined(__NetBSD__)
+    return ::fdatasync(fd) == 0;
+#else
+    return ::fsync(fd) == 0;
+#endif
+}
+
+bool preallocate(FILE *fp, size_t size) noexcept {
+    const int fd = ::fileno(fp);
+#if defined(__linux__)
+    return ::fallocate(fd, 0, 0, static_cast<off_t>(size)) == 0;
+#elif defined(__APPLE__)
+    (void)fd;
+    (void)size;
+    return false;
+#else
+    return ::posix_fallocate(fd, 0, static_cast<off_t>(size)) == 0;
+#endif
+}
+
+size_t file_offset(FILE *fp) {
+    if (fp == nullptr) {
+        throw_spdlog_ex("Failed getting file offset. fd is null");
+    }
+    const off_t offset = ::lseek(::fileno(fp), 0, SEEK_CUR);
+    if (offset < 0) {
+        throw_spdlog_ex("Failed getting file offset", errno);
+    }
+    return static_cast<size_t>(offset);
+}
+
+bool seek(FILE *fp, size_t offset) noexcept {
+    // off_t is 32 bit on 32 bit systems built without _FILE_OFFSET_BITS=64
+    if (offset > static_cast<size_t>(std::numeric_limits<off_t>::max())) {
+        errno = EOVERFLOW;
+        return false;
+    }
+    return ::fseeko(fp, static_cast<off_t>(offset), SEEK_SET) == 0;
+}
+
+bool truncate(FILE *fp, size_t size) noexcept { return ::ftruncate(::fileno(fp), static_cast<off_t>(size)) == 0; }
+
+int open_direct(const filename_t &filename) noexcept {
+#if defined(O_DIRECT)
+    return ::open(filename.c_str(), O_RDWR | O_DIRECT | O_CLOEXEC);
+#elif defined(__APPLE__)
+    const int fd = ::open(filename.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd >= 0 && ::fcntl(fd, F_NOCACHE, 1) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+#else
+    (void)filename;
+    return -1;
+#endif
+}
+
+bool pwrite_bytes(int fd, const void *ptr, size_t n, size_t offset) noexcept {
+    const auto *data = static_cast<const char *>(ptr);
+    while (n > 0) {
+        const auto written = ::pwrite(fd, data, n, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        n -= static_cast<size_t>(written);
+        offset += static_cast<size_t>(written);
+    }
+    return true;
+}
+
+long long pread_bytes(int fd, void *ptr, size_t n, size_t offset) noexcept {
+    for (;;) {
+        const auto bytes_read = ::pread(fd, ptr, n, static_cast<off_t>(offset));
+        if (bytes_read >= 0 || errno != EINTR) {
+            return static_cast<long long>(bytes_read);
+        }
+    }
+}
+
+bool start_writeback(FILE *fp, size_t offset, size_t len) noexcept {
+#if defined(__linux__)
+    return ::sync_file_range(::fileno(fp), static_cast<off_t>(offset), static_cast<off_t>(len), SYNC_FILE_RANGE_WRITE) == 0;
+#else
+    (void)fp;
+    (void)offset;
+    (void)len;
+    return false;
+#endif
+}
+
+bool drop_cache(FILE *fp, size_t offset, size_t len) noexcept {
+#if defined(POSIX_FADV_DONTNEED)
+    return ::posix_fadvise(::fileno(fp), static_cast<off_t>(offset), static_cast<off_t>(len), POSIX_FADV_DONTNEED) == 0;
+#else
+    (void)fp;
+    (void)offset;
+    (void)len;
+    return false;
+#endif
+}
+
 // Non locking ::fwrite if possible (SPDLOG_FWRITE_UNLOCKED defined) or use the regular locking fwrite
 bool fwrite_bytes(const void *ptr, const size_t n_bytes, FILE *fp) {
 #if defined(SPDLOG_FWRITE_UNLOCKED)
@@ -284,6 +404,42 @@ bool fwrite_bytes(const void *ptr, const size_t n_bytes, FILE *fp) {
 #endif
 }
 
+bool write_spans(const string_view_t *spans, size_t count, FILE *fp) {
+#ifdef IOV_MAX
+    constexpr size_t max_iov = IOV_MAX < 64 ? IOV_MAX : 64;
+#else
+    constexpr size_t max_iov = 16;
+#endif
+    const int fd = ::fileno(fp);
+    std::array<iovec, max_iov> iov;
+    size_t offset = 0;  // bytes of spans[0] already written
+    while (count > 0) {
+        const size_t n_iov = (std::min)(count, max_iov);
+        for (size_t i = 0; i < n_iov; ++i) {
+            const size_t skip = i == 0 ? offset : 0;
+            iov[i].iov_base = const_cast<char *>(spans[i].data() + skip);
+            iov[i].iov_len = spans[i].size() - skip;
+        }
+        const auto written = ::writev(fd, iov.data(), static_cast<int>(n_iov));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        // skip the fully written spans and remember how much of the next one was written
+        auto remaining = static_cast<size_t>(written);
+        while (count > 0 && remaining >= spans->size() - offset) {
+            remaining -= spans->size() - offset;
+            offset = 0;
+            ++spans;
+            --count;
+        }
+        offset += remaining;
+    }
+    return true;
+}
+
 }  // namespace os
 }  // namespace details
 }  // namespace spdlog
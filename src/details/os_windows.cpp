@@ -9,6 +9,7 @@
 #include "spdlog/details/windows_include.h" // must be included before fileapi.h etc.
 // clang-format on
 
+#include <fcntl.h>    // for _O_BINARY
 #include <fileapi.h>  // for FlushFileBuffers
 #include <io.h>       // for _get_osfhandle, _isatty, _fileno
 #include <process.h>  // for _get_pid
@@ -18,6 +19,7 @@
 #include <array>
 #include <cassert>
 #include <chrono>
+#include <climits>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -240,6 +242,88 @@ std::string getenv(const char *field) {
 // Return true on success
 bool fsync(FILE *fp) { return FlushFileBuffers(reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(fp)))) != 0; }
 
+int dup_fd(FILE *fp) noexcept { return ::_dup(::_fileno(fp)); }
+
+void close_fd(int fd) noexcept { ::_close(fd); }
+
+bool fdatasync(int fd) noexcept { return FlushFileBuffers(reinterpret_cast<HANDLE>(_get_osfhandle(fd))) != 0; }
+
+bool preallocate(FILE *fp, size_t size) noexcept {
+    FILE_ALLOCATION_INFO info;
+    info.AllocationSize.QuadPart = static_cast<LONGLONG>(size);
+    const auto handle = reinterpret_cast<HANDLE>(_get_osfhandle(::_fileno(fp)));
+    return SetFileInformationByHandle(handle, FileAllocationInfo, &info, sizeof(info)) != 0;
+}
+
+size_t file_offset(FILE *fp) {
+    if (fp == nullptr) {
+        throw_spdlog_ex("Failed getting file offset. fd is null");
+    }
+    const __int64 offset = ::_lseeki64(::_fileno(fp), 0, SEEK_CUR);
+    if (offset < 0) {
+        throw_spdlog_ex("Failed getting file offset", errno);
+    }
+    return static_cast<size_t>(offset);
+}
+
+bool seek(FILE *fp, size_t offset) noexcept { return ::_fseeki64(fp, static_cast<__int64>(offset), SEEK_SET) == 0; }
+
+bool truncate(FILE *fp, size_t size) noexcept { return ::_chsize_s(::_fileno(fp), static_cast<__int64>(size)) == 0; }
+
+int open_direct(const filename_t &filename) noexcept {
+    const HANDLE handle =
+        ::CreateFileW(filename.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                      nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_NO_BUFFERING, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return -1;
+    }
+    const int fd = ::_open_osfhandle(reinterpret_cast<intptr_t>(handle), _O_BINARY);
+    if (fd < 0) {
+        ::CloseHandle(handle);
+    }
+    return fd;
+}
+
+static OVERLAPPED overlapped_at(size_t offset) noexcept {
+    OVERLAPPED overlapped{};
+    overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFFu);
+    overlapped.OffsetHigh = static_cast<DWORD>(static_cast<unsigned long long>(offset) >> 32);
+    return overlapped;
+}
+
+bool pwrite_bytes(int fd, const void *ptr, size_t n, size_t offset) noexcept {
+    const auto handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+    const auto *data = static_cast<const char *>(ptr);
+    while (n > 0) {
+        // chunks of 1GB keep the block alignment
+        const auto chunk = static_cast<DWORD>((std::min)(n, static_cast<size_t>(1) << 30));
+        OVERLAPPED overlapped = overlapped_at(offset);
+        DWORD written = 0;
+        if (!::WriteFile(handle, data, chunk, &written, &overlapped)) {
+            return false;
+        }
+        data += written;
+        n -= written;
+        offset += written;
+    }
+    return true;
+}
+
+long long pread_bytes(int fd, void *ptr, size_t n, size_t offset) noexcept {
+    const auto handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+    const auto chunk = static_cast<DWORD>((std::min)(n, static_cast<size_t>(1) << 30));
+    OVERLAPPED overlapped = overlapped_at(offset);
+    DWORD bytes_read = 0;
+    if (!::ReadFile(handle, ptr, chunk, &bytes_read, &overlapped)) {
+        return ::GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+    }
+    return static_cast<long long>(bytes_read);
+}
+
+bool start_writeback(FILE *, size_t, size_t) noexcept { return false; }
+
+bool drop_cache(FILE *, size_t, size_t) noexcept { return false; }
+
 // Non locking fwrite if possible (SPDLOG_FWRITE_UNLOCKED defined) or use the regular locking fwrite
 bool fwrite_bytes(const void *ptr, const size_t n_bytes, FILE *fp) {
 #if defined(SPDLOG_FWRITE_UNLOCKED)
@@ -248,6 +332,24 @@ bool fwrite_bytes(const void *ptr, const size_t n_bytes, FILE *fp) {
     return std::fwrite(ptr, 1, n_bytes, fp) == n_bytes;
 #endif
 }
+
+bool write_spans(const string_view_t *spans, size_t count, FILE *fp) {
+    const int fd = ::_fileno(fp);
+    for (size_t i = 0; i < count; ++i) {
+        const char *data = spans[i].data();
+        size_t remaining = spans[i].size();
+        while (remaining > 0) {
+            const auto chunk = static_cast<unsigned int>((std::min)(remaining, static_cast<size_t>(INT_MAX)));
+            const int written = ::_write(fd, data, chunk);
+            if (written < 0) {
+                return false;
+            }
+            data += written;
+            remaining -= static_cast<size_t>(written);
+        }
+    }
+    return true;
+}
 }  // namespace os
 }  // namespace details
 }  // namespace spdlog
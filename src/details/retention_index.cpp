@@ -0,0 +1,123 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "spdlog/details/retention_index.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <map>
+
+#include "spdlog/details/os.h"
+
+namespace spdlog {
+namespace details {
+
+retention_index::retention_index(size_t max_files, size_t max_bytes) noexcept
+    : max_files_{max_files},
+      max_bytes_{max_bytes} {}
+
+void retention_index::scan(const filename_t &sample1, const filename_t &sample2) {
+    using string_type = filename_t::string_type;
+    const string_type a = sample1.filename().native();
+    const string_type b = sample2.filename().native();
+    const string_type gz_suffix = filename_t(SPDLOG_FILENAME_T(".gz")).native();
+    const auto is_digit = [](filename_t::value_type c) { return c >= '0' && c <= '9'; };
+
+    files_.clear();
+    total_bytes_ = 0;
+    scanned_ = true;
+    // names of different lengths (e.g. month names) can't be matched strictly: rather than risk deleting
+    // unrelated files, only the files created from now on are indexed
+    if (a.size() != b.size()) {
+        return;
+    }
+    const auto matches = [&](const string_type &name) {
+        if (name.size() != a.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < name.size(); i++) {
+            if (a[i] == b[i] ? name[i] != a[i] : is_digit(a[i]) && is_digit(b[i]) && !is_digit(name[i])) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    struct found_file {
+        size_t size = 0;
+        std::filesystem::file_time_type time = std::filesystem::file_time_type::min();
+    };
+    std::map<string_type, found_file> found;  // by uncompressed name
+    const filename_t dir = os::dir_name(sample1);
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(dir.empty() ? filename_t(SPDLOG_FILENAME_T(".")) : dir, ec), end;
+         !ec && it != end; it.increment(ec)) {
+        string_type name = it->path().filename().native();
+        if (name.size() > gz_suffix.size() && name.compare(name.size() - gz_suffix.size(), gz_suffix.size(), gz_suffix) == 0) {
+            name.resize(name.size() - gz_suffix.size());
+        }
+        std::error_code file_ec;
+        if (!matches(name) || !it->is_regular_file(file_ec)) {
+            continue;
+        }
+        const auto size = it->file_size(file_ec);
+        const auto time = it->last_write_time(file_ec);
+        if (file_ec) {
+            continue;  // deleted meanwhile
+        }
+        auto &file = found[name];
+        file.size += static_cast<size_t>(size);
+        file.time = (std::max)(file.time, time);
+    }
+
+    std::vector<std::pair<std::filesystem::file_time_type, const string_type *>> by_time;
+    by_time.reserve(found.size());
+    for (const auto &file : found) {
+        by_time.emplace_back(file.second.time, &file.first);
+    }
+    std::sort(by_time.begin(), by_time.end(), [](const auto &x, const auto &y) {
+        return x.first != y.first ? x.first < y.first : *x.second < *y.second;
+    });
+
+    for (const auto &file : by_time) {
+        const size_t size = found[*file.second].size;
+        files_.push_back(entry{dir.empty() ? filename_t(*file.second) : dir / *file.second, size});
+        total_bytes_ += size;
+    }
+}
+
+void retention_index::set_current(const filename_t &filename, size_t size) {
+    if (files_.empty() || files_.back().filename != filename) {
+        remove(filename);
+        files_.push_back(entry{filename, 0});
+    }
+    total_bytes_ = total_bytes_ - files_.back().size + size;
+    files_.back().size = size;
+}
+
+void retention_index::remove(const filename_t &filename) {
+    const auto it = std::find_if(files_.begin(), files_.end(), [&](const entry &e) { return e.filename == filename; });
+    if (it != files_.end()) {
+        total_bytes_ -= it->size;
+        files_.erase(it);
+    }
+}
+
+std::vector<filename_t> retention_index::expire() {
+    std::vector<filename_t> expired;
+    while (files_.size() > 1 &&
+           ((max_files_ > 0 && files_.size() > max_files_) || (max_bytes_ > 0 && total_bytes_ > max_bytes_))) {
+        total_bytes_ -= files_.front().size;
+        expired.push_back(std::move(files_.front().filename));
+        files_.pop_front();
+    }
+    return expired;
+}
+
+void retention_index::set_limits(size_t max_files, size_t max_bytes) noexcept {
+    max_files_ = max_files;
+    max_bytes_ = max_bytes;
+}
+
+}  // namespace details
+}  // namespace spdlog
@@ -0,0 +1,128 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "spdlog/details/rotation_worker.h"
+
+#include <exception>
+#include <utility>
+
+namespace spdlog {
+namespace details {
+
+rotation_worker::rotation_worker()
+    : thread_{[this] { run_(); }} {}
+
+rotation_worker::~rotation_worker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+    if (prepared_ != nullptr) {
+        std::fclose(prepared_);
+    }
+}
+
+void rotation_worker::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    cv_.notify_all();
+}
+
+void rotation_worker::prepare(const file_helper &helper, filename_t fname, bool truncate) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wanted_name_ = fname;
+    }
+    post([this, &helper, fname = std::move(fname), truncate] {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (wanted_name_ != fname) {
+                return;  // cancelled by take_prepared() or superseded by a later prepare()
+            }
+            preparing_ = true;
+        }
+        std::FILE *fp = nullptr;
+        try {
+            fp = helper.prepare(fname, truncate);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            preparing_ = false;
+            cv_.notify_all();
+            throw;
+        }
+        std::FILE *old = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            preparing_ = false;
+            old = prepared_;
+            prepared_ = fp;
+            prepared_name_ = fname;
+        }
+        cv_.notify_all();
+        if (old != nullptr) {
+            std::fclose(old);
+        }
+    });
+}
+
+std::FILE *rotation_worker::take_prepared(const filename_t &fname) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // if the worker is opening the file right now, waiting for it is cheaper than opening it twice
+    cv_.wait(lock, [this] { return !preparing_; });
+    wanted_name_.clear();
+    if (prepared_ == nullptr || prepared_name_ != fname) {
+        return nullptr;
+    }
+    return std::exchange(prepared_, nullptr);
+}
+
+void rotation_worker::wait_idle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return tasks_.empty() && !busy_; });
+}
+
+void rotation_worker::check_error() {
+    std::string error;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error.swap(error_);
+    }
+    if (!error.empty()) {
+        throw_spdlog_ex(error);
+    }
+}
+
+void rotation_worker::run_() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+        if (tasks_.empty()) {
+            return;  // stop_ and nothing left to do
+        }
+        auto task = std::move(tasks_.front());
+        tasks_.pop_front();
+        busy_ = true;
+        lock.unlock();
+        std::string error;
+        try {
+            task();
+        } catch (const std::exception &ex) {
+            error = ex.what();
+        } catch (...) {
+            error = "Unknown exception in rotation worker";
+        }
+        lock.lock();
+        busy_ = false;
+        if (error_.empty()) {
+            error_ = std::move(error);
+        }
+        cv_.notify_all();
+    }
+}
+
+}  // namespace details
+}  // namespace spdlog
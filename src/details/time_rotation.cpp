@@ -0,0 +1,131 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "spdlog/details/time_rotation.h"
+
+#include <algorithm>
+#include <tuple>
+
+#include "spdlog/details/os.h"
+
+namespace spdlog {
+namespace details {
+
+static constexpr std::int64_t seconds_per_day = 24 * 60 * 60;
+
+static std::int64_t floor_div(std::int64_t a, std::int64_t b) noexcept {
+    const std::int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+// broken down local time of the given local seconds since the epoch
+static std::tm local_tm(std::int64_t local_seconds, int isdst) noexcept {
+    const std::int64_t days = floor_div(local_seconds, seconds_per_day);
+    const auto seconds_of_day = static_cast<int>(local_seconds - days * seconds_per_day);
+    std::int64_t year;
+    unsigned month, day;
+    time_rotation::civil_from_days(days, year, month, day);
+
+    std::tm tm{};
+    tm.tm_year = static_cast<int>(year - 1900);
+    tm.tm_mon = static_cast<int>(month) - 1;
+    tm.tm_mday = static_cast<int>(day);
+    tm.tm_hour = seconds_of_day / 3600;
+    tm.tm_min = seconds_of_day % 3600 / 60;
+    tm.tm_sec = seconds_of_day % 60;
+    tm.tm_wday = static_cast<int>(days - floor_div(days + 4, 7) * 7 + 4);  // 1970-01-01 was a thursday
+    tm.tm_yday = static_cast<int>(days - time_rotation::days_from_civil(year, 1, 1));
+    tm.tm_isdst = isdst;
+    return tm;
+}
+
+time_rotation::time_rotation(std::chrono::minutes interval, std::chrono::minutes offset)
+    : interval_{interval},
+      offset_{offset} {
+    if (interval_.count() <= 0 || interval_ > std::chrono::hours(24)) {
+        throw_spdlog_ex("time_rotation: interval must be between 1 minute and 24 hours");
+    }
+    if (offset_.count() < 0 || offset_ >= std::chrono::hours(24)) {
+        throw_spdlog_ex("time_rotation: offset must be less than 24 hours");
+    }
+}
+
+time_rotation::period time_rotation::period_of(log_clock::time_point tp) {
+    const std::int64_t now = std::chrono::floor<std::chrono::seconds>(tp.time_since_epoch()).count();
+    const std::int64_t utc_offset = utc_offset_(now);
+    const std::int64_t offset = std::chrono::seconds(offset_).count();
+    const std::int64_t interval = std::chrono::seconds(interval_).count();
+
+    // position in the local day, counted from the daily offset
+    const std::int64_t local = now + utc_offset;
+    std::int64_t day_start = floor_div(local, seconds_per_day) * seconds_per_day + offset;
+    if (local < day_start) {
+        day_start -= seconds_per_day;
+    }
+    const std::int64_t start_in_day = (local - day_start) / interval * interval;
+    const std::int64_t end_in_day = (std::min)(start_in_day + interval, seconds_per_day);
+    const std::int64_t start = day_start + start_in_day;
+    const std::int64_t end = day_start + end_in_day;
+
+    period result;
+    result.start = log_clock::time_point(std::chrono::seconds(start - utc_offset));
+    result.start_tm = local_tm(start, cached_isdst_);
+    // the offset may change until the end of the period
+    std::int64_t end_utc = end - utc_offset_(end - utc_offset);
+    if (end_utc <= now) {
+        end_utc = end - utc_offset;
+    }
+    result.end = log_clock::time_point(std::chrono::seconds(end_utc));
+    return result;
+}
+
+// see http://howardhinnant.github.io/date_algorithms.html
+std::int64_t time_rotation::days_from_civil(std::int64_t year, unsigned month, unsigned day) noexcept {
+    year -= month <= 2 ? 1 : 0;
+    const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const auto yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+void time_rotation::civil_from_days(std::int64_t days, std::int64_t &year, unsigned &month, unsigned &day) noexcept {
+    days += 719468;
+    const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const auto doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = static_cast<std::int64_t>(yoe) + era * 400 + (month <= 2 ? 1 : 0);
+}
+
+std::int64_t time_rotation::utc_offset_(std::int64_t utc_seconds) {
+    if (utc_seconds >= cache_from_ && utc_seconds <= cache_until_) {
+        return cached_offset_;
+    }
+    const std::tm tm = os::localtime(static_cast<std::time_t>(utc_seconds));
+    const std::int64_t offset = os::utc_minutes_offset(tm) * std::int64_t{60};
+    const std::tm next_day_tm = os::localtime(static_cast<std::time_t>(utc_seconds + seconds_per_day));
+    const std::int64_t next_day_offset = os::utc_minutes_offset(next_day_tm) * std::int64_t{60};
+
+    cached_offset_ = offset;
+    cached_isdst_ = tm.tm_isdst;
+    cache_from_ = utc_seconds;
+    // offsets change at most a couple of times a year - if it's the same a day later it holds until then
+    cache_until_ = next_day_offset == offset ? utc_seconds + seconds_per_day : utc_seconds;
+    return offset;
+}
+
+filename_t insert_before_extension(const filename_t &filename, string_view_t suffix) {
+    filename_t basename, ext;
+    std::tie(basename, ext) = os::split_by_extension(filename);
+    filename_t::string_type name = basename.native();
+    name.append(suffix.begin(), suffix.end());
+    name += ext.native();
+    return name;
+}
+
+}  // namespace details
+}  // namespace spdlog
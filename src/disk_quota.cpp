@@ -0,0 +1,206 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "spdlog/disk_quota.h"
+
+#include <algorithm>
+
+#include "spdlog/details/os.h"
+
+namespace spdlog {
+
+disk_quota::disk_quota(size_t max_bytes)
+    : max_bytes_{max_bytes} {}
+
+void disk_quota::set_max_bytes(size_t max_bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        max_bytes_ = max_bytes;
+        update_sampling_bytes_();
+    }
+    add_bytes_(0);
+}
+
+void disk_quota::set_sampling(double usage_ratio, size_t keep_one_in) {
+    if (usage_ratio <= 0) {
+        throw_spdlog_ex("disk_quota: sampling usage ratio must be positive");
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sampling_ratio_ = usage_ratio;
+        keep_one_in_ = keep_one_in;
+        update_sampling_bytes_();
+    }
+    add_bytes_(0);
+}
+
+disk_quota_stats disk_quota::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    disk_quota_stats stats;
+    stats.max_bytes = max_bytes_;
+    stats.bytes_on_disk = total_bytes_;
+    stats.bytes_written = bytes_written_;
+    stats.files = files_;
+    stats.sinks = members_.size();
+    stats.evicted_files = evicted_files_;
+    stats.evicted_bytes = evicted_bytes_;
+    stats.sampled_out = sampled_out_;
+    stats.sampling = sampling_;
+    return stats;
+}
+
+void disk_quota::enforce() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t max_bytes = max_bytes_;
+    while (max_bytes > 0 && total_bytes_ > max_bytes) {
+        // the oldest rotated file across all the sinks
+        auto oldest = members_.end();
+        for (auto it = members_.begin(); it != members_.end(); ++it) {
+            if (!it->rotated.empty() && (oldest == members_.end() || it->rotated.front().time < oldest->rotated.front().time)) {
+                oldest = it;
+            }
+        }
+        if (oldest == members_.end()) {
+            break;  // only current files left
+        }
+        const tracked_file file = std::move(oldest->rotated.front());
+        oldest->rotated.pop_front();
+        details::os::remove_if_exists(file.filename);
+        details::os::remove_if_exists(filename_t(file.filename) += SPDLOG_FILENAME_T(".gz"));
+        files_--;
+        rotated_files_--;
+        evicted_files_++;
+        evicted_bytes_ += file.size;
+        sub_bytes_(file.size);
+    }
+}
+
+void disk_quota::update_sampling_bytes_() {
+    const size_t max_bytes = max_bytes_;
+    if (keep_one_in_ <= 1 || max_bytes == 0) {
+        sampling_bytes_ = 0;
+    } else {
+        sampling_bytes_ = (std::max)(static_cast<size_t>(sampling_ratio_ * static_cast<double>(max_bytes)), size_t{1});
+    }
+}
+
+void disk_quota::add_bytes_(size_t n) {
+    const size_t total = total_bytes_.fetch_add(n) + n;
+    const size_t sampling_bytes = sampling_bytes_.load(std::memory_order_relaxed);
+    const bool sampling = sampling_bytes > 0 && total > sampling_bytes;
+    if (sampling != sampling_.load(std::memory_order_relaxed)) {
+        sampling_ = sampling;
+    }
+    const size_t max_bytes = max_bytes_.load(std::memory_order_relaxed);
+    if (max_bytes > 0 && total > max_bytes && rotated_files_.load(std::memory_order_relaxed) > 0) {
+        enforce();
+    }
+}
+
+void disk_quota::sub_bytes_(size_t n) {
+    const size_t total = total_bytes_.fetch_sub(n) - n;
+    const size_t sampling_bytes = sampling_bytes_.load(std::memory_order_relaxed);
+    sampling_ = sampling_bytes > 0 && total > sampling_bytes;
+}
+
+namespace details {
+
+quota_client::quota_client(std::shared_ptr<disk_quota> quota, quota_priority priority)
+    : quota_{std::move(quota)} {
+    if (!quota_) {
+        throw_spdlog_ex("quota_client: null disk_quota");
+    }
+    std::lock_guard<std::mutex> lock(quota_->mutex_);
+    quota_->members_.emplace_back();
+    state_ = std::prev(quota_->members_.end());
+    state_->priority = priority;
+}
+
+quota_client::~quota_client() {
+    size_t bytes;
+    {
+        std::lock_guard<std::mutex> lock(quota_->mutex_);
+        bytes = state_->current_size;
+        for (const auto &file : state_->rotated) {
+            bytes += file.size;
+        }
+        quota_->files_ -= state_->rotated.size() + (state_->current.empty() ? 0 : 1);
+        quota_->rotated_files_ -= state_->rotated.size();
+        quota_->members_.erase(state_);
+    }
+    quota_->sub_bytes_(bytes);
+}
+
+void quota_client::add_existing(const filename_t &filename) {
+    std::error_code ec;
+    filename_t path = filename;
+    if (!std::filesystem::is_regular_file(path, ec)) {
+        path += SPDLOG_FILENAME_T(".gz");
+        if (!std::filesystem::is_regular_file(path, ec)) {
+            return;
+        }
+    }
+    const auto size = static_cast<size_t>(std::filesystem::file_size(path, ec));
+    const auto time = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(quota_->mutex_);
+        auto &rotated = state_->rotated;
+        auto pos = std::find_if(rotated.begin(), rotated.end(), [&](const disk_quota::tracked_file &f) { return f.time > time; });
+        rotated.insert(pos, disk_quota::tracked_file{filename, size, time});
+        quota_->files_++;
+        quota_->rotated_files_++;
+    }
+    quota_->add_bytes_(size);
+}
+
+void quota_client::set_current(const filename_t &filename, size_t size) {
+    size_t previous_size = 0;
+    {
+        std::lock_guard<std::mutex> lock(quota_->mutex_);
+        if (state_->current == filename) {
+            previous_size = state_->current_size;
+        } else {
+            if (!state_->current.empty()) {
+                // the current file is rotated
+                state_->rotated.push_back(disk_quota::tracked_file{state_->current, state_->current_size,
+                                                                   std::filesystem::file_time_type::clock::now()});
+                quota_->rotated_files_++;
+            }
+            quota_->files_++;
+        }
+        state_->current = filename;
+        state_->current_size = size;
+    }
+    quota_->sub_bytes_(previous_size);
+    quota_->add_bytes_(size);
+}
+
+void quota_client::removed(const filename_t &filename) {
+    size_t size = 0;
+    {
+        std::lock_guard<std::mutex> lock(quota_->mutex_);
+        auto &rotated = state_->rotated;
+        const auto is_file = [&](const disk_quota::tracked_file &f) { return f.filename == filename; };
+        const auto it = std::find_if(rotated.begin(), rotated.end(), is_file);
+        if (it != rotated.end()) {
+            size = it->size;
+            rotated.erase(it);
+            quota_->files_--;
+            quota_->rotated_files_--;
+        } else if (!state_->current.empty() && state_->current == filename) {
+            size = state_->current_size;
+            state_->current.clear();
+            state_->current_size = 0;
+            quota_->files_--;
+        } else {
+            return;
+        }
+    }
+    quota_->sub_bytes_(size);
+}
+
+}  // namespace details
+}  // namespace spdlog
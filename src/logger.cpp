@@ -3,6 +3,7 @@
 
 #include "spdlog/logger.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <mutex>
 
@@ -26,7 +27,10 @@ logger::logger(logger &&other) noexcept
       flush_level_(other.flush_level_.load(std::memory_order_relaxed)),
       custom_err_handler_(std::move(other.custom_err_handler_)) {}
 
-void logger::set_level(level level) { level_.store(level); }
+void logger::set_level(level level) {
+    level_.store(level);
+    sinks::sink::levels_changed();
+}
 
 level logger::log_level() const { return level_.load(std::memory_order_relaxed); }
 
@@ -60,7 +64,23 @@ level logger::flush_level() const { return flush_level_.load(std::memory_order_r
 // sinks
 const std::vector<sink_ptr> &logger::sinks() const { return sinks_; }
 
-std::vector<sink_ptr> &logger::sinks() { return sinks_; }
+std::vector<sink_ptr> &logger::sinks() {
+    // the caller may change the sinks at any time from now on
+    if (!sinks_exposed_.exchange(true)) {
+        sinks::sink::levels_changed();
+    }
+    return sinks_;
+}
+
+void logger::add_sink(sink_ptr sink) {
+    sinks_.push_back(std::move(sink));
+    sinks::sink::levels_changed();
+}
+
+void logger::remove_sink(const sink_ptr &sink) {
+    sinks_.erase(std::remove(sinks_.begin(), sinks_.end(), sink), sinks_.end());
+    sinks::sink::levels_changed();
+}
 
 // error handler
 void logger::set_error_handler(err_handler handler) { custom_err_handler_ = std::move(handler); }
@@ -73,6 +93,22 @@ std::shared_ptr<logger> logger::clone(std::string logger_name) {
 }
 
 // private/protected methods
+
+// the version is read first (acquire, paired with the release of levels_changed()): the levels read after it
+// are at least as new as the version, and if a level changes while computing, the next call computes again.
+level logger::update_effective_level_() const {
+    const uint64_t version = sinks::sink::levels_version();
+    level result = level_.load(std::memory_order_relaxed);
+    if (!sinks_exposed_.load(std::memory_order_relaxed)) {
+        level min_sink_level = level::off;
+        for (const auto &sink : sinks_) {
+            min_sink_level = (std::min)(min_sink_level, sink->log_level());
+        }
+        result = (std::max)(result, min_sink_level);
+    }
+    effective_level_.store((version << 8) | static_cast<uint64_t>(result), std::memory_order_relaxed);
+    return result;
+}
 void logger::flush_() {
     for (auto &sink : sinks_) {
         try {
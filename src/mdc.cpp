@@ -0,0 +1,101 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "spdlog/mdc.h"
+
+#include <algorithm>
+
+namespace spdlog {
+
+using details::mdc_data;
+
+#if !defined(SPDLOG_NO_TLS)
+
+// copy-on-write: build a new block from the current entries with the given key replaced/added.
+static std::shared_ptr<const mdc_data> make_context_with(const std::shared_ptr<const mdc_data> &current,
+                                                 const std::string &key,
+                                                 const std::string &value) {
+    std::vector<mdc_data::entry_type> entries;
+    if (current) {
+        entries = current->entries();
+    }
+    auto it = std::find_if(entries.begin(), entries.end(), [&key](const mdc_data::entry_type &e) { return e.first == key; });
+    if (it != entries.end()) {
+        it->second = value;
+    } else {
+        entries.emplace_back(key, value);
+    }
+    return std::make_shared<const mdc_data>(std::move(entries));
+}
+
+std::shared_ptr<const mdc_data> &mdc::current_ref_() {
+    static thread_local std::shared_ptr<const mdc_data> current;
+    return current;
+}
+
+void mdc::put(const std::string &key, const std::string &value) {
+    auto &current = current_ref_();
+    current = make_context_with(current, key, value);
+}
+
+void mdc::remove(const std::string &key) {
+    auto &current = current_ref_();
+    if (!current) {
+        return;
+    }
+    auto entries = current->entries();
+    auto it = std::find_if(entries.begin(), entries.end(), [&key](const mdc_data::entry_type &e) { return e.first == key; });
+    if (it == entries.end()) {
+        return;
+    }
+    entries.erase(it);
+    current = entries.empty() ? nullptr : std::make_shared<const mdc_data>(std::move(entries));
+}
+
+void mdc::clear() { current_ref_().reset(); }
+
+std::string mdc::get(const std::string &key) {
+    const auto &current = current_ref_();
+    if (current) {
+        for (const auto &entry : current->entries()) {
+            if (entry.first == key) {
+                return entry.second;
+            }
+        }
+    }
+    return {};
+}
+
+const mdc_data *mdc::current() noexcept { return current_ref_().get(); }
+
+mdc_guard::mdc_guard(const std::string &key, const std::string &value)
+    : prev_(mdc::current_ref_()) {
+    mdc::put(key, value);
+}
+
+mdc_guard::~mdc_guard() { mdc::current_ref_() = std::move(prev_); }
+
+#else  // SPDLOG_NO_TLS - no thread local context, all functions are no-op
+
+std::shared_ptr<const mdc_data> &mdc::current_ref_() {
+    static std::shared_ptr<const mdc_data> empty;
+    return empty;
+}
+
+void mdc::put(const std::string &, const std::string &) {}
+
+void mdc::remove(const std::string &) {}
+
+void mdc::clear() {}
+
+std::string mdc::get(const std::string &) { return {}; }
+
+const mdc_data *mdc::current() noexcept { return nullptr; }
+
+mdc_guard::mdc_guard(const std::string &, const std::string &) {}
+
+mdc_guard::~mdc_guard() = default;
+
+#endif  // SPDLOG_NO_TLS
+
+}  // namespace spdlog
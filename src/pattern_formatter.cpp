@@ -18,6 +18,7 @@
 #include "spdlog/details/os.h"
 #include "spdlog/fmt/fmt.h"
 #include "spdlog/formatter.h"
+#include "spdlog/mdc.h"
 
 namespace spdlog {
 namespace details {
@@ -575,6 +576,74 @@ public:
     }
 };
 
+// key/value fields in the form of "key1=value1 key2=value2"
+template <typename ScopedPadder>
+class fields_formatter final : public flag_formatter {
+public:
+    explicit fields_formatter(padding_info padinfo)
+        : flag_formatter(padinfo) {}
+
+    void format(const details::log_msg &msg, const std::tm &, memory_buf_t &dest) override {
+        if (!padinfo_.enabled()) {
+            format_fields_(msg, dest);
+            return;
+        }
+        memory_buf_t fields_buf;
+        format_fields_(msg, fields_buf);
+        ScopedPadder p(fields_buf.size(), padinfo_, dest);
+        dest.append(fields_buf.data(), fields_buf.data() + fields_buf.size());
+    }
+
+private:
+    static void format_fields_(const details::log_msg &msg, memory_buf_t &dest) {
+        for (size_t i = 0; i < msg.fields_count; ++i) {
+            if (i > 0) {
+                dest.push_back(' ');
+            }
+            fmt_helper::append_string_view(msg.fields[i].key, dest);
+            dest.push_back('=');
+            fmt_helper::append_field_value(msg.fields[i], dest);
+        }
+    }
+};
+
+// mapped diagnostic context in the form of "key1=value1 key2=value2"
+template <typename ScopedPadder>
+class mdc_formatter final : public flag_formatter {
+public:
+    explicit mdc_formatter(padding_info padinfo)
+        : flag_formatter(padinfo) {}
+
+    void format(const details::log_msg &msg, const std::tm &, memory_buf_t &dest) override {
+        if (msg.context == nullptr) {
+            ScopedPadder p(0, padinfo_, dest);
+            return;
+        }
+        if (!padinfo_.enabled()) {
+            format_context_(*msg.context, dest);
+            return;
+        }
+        memory_buf_t context_buf;
+        format_context_(*msg.context, context_buf);
+        ScopedPadder p(context_buf.size(), padinfo_, dest);
+        dest.append(context_buf.data(), context_buf.data() + context_buf.size());
+    }
+
+private:
+    static void format_context_(const details::mdc_data &context, memory_buf_t &dest) {
+        bool first = true;
+        for (const auto &entry : context.entries()) {
+            if (!first) {
+                dest.push_back(' ');
+            }
+            first = false;
+            fmt_helper::append_string_view(entry.first, dest);
+            dest.push_back('=');
+            fmt_helper::append_string_view(entry.second, dest);
+        }
+    }
+};
+
 class ch_formatter final : public flag_formatter {
 public:
     explicit ch_formatter(char ch)
@@ -931,6 +1000,14 @@ void pattern_formatter::handle_flag_(char flag, details::padding_info padding) {
             formatters_.push_back(std::make_unique<details::v_formatter<Padder>>(padding));
             break;
 
+        case ('V'):  // key/value fields
+            formatters_.push_back(std::make_unique<details::fields_formatter<Padder>>(padding));
+            break;
+
+        case ('&'):  // mapped diagnostic context
+            formatters_.push_back(std::make_unique<details::mdc_formatter<Padder>>(padding));
+            break;
+
         case ('a'):  // weekday
             formatters_.push_back(std::make_unique<details::a_formatter<Padder>>(padding));
             need_localtime_ = true;
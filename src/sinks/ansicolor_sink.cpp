@@ -5,7 +5,6 @@
 
 #include <mutex>
 
-#include "spdlog/details/null_mutex.h"
 #include "spdlog/details/os.h"
 #include "spdlog/pattern_formatter.h"
 
@@ -14,9 +13,8 @@ namespace sinks {
 
 template <typename Mutex>
 ansicolor_sink<Mutex>::ansicolor_sink(FILE *target_file, color_mode mode)
-    : target_file_(target_file)
-
-{
+    : target_file_(target_file),
+      flusher_(target_file, details::console_flusher::locked_flush(base_sink<Mutex>::mutex_, target_file)) {
     set_color_mode(mode);
     colors_.at(level_to_number(level::trace)) = to_string_(white);
     colors_.at(level_to_number(level::debug)) = to_string_(cyan);
@@ -27,6 +25,12 @@ ansicolor_sink<Mutex>::ansicolor_sink(FILE *target_file, color_mode mode)
     colors_.at(level_to_number(level::off)) = to_string_(reset);
 }
 
+template <typename Mutex>
+ansicolor_sink<Mutex>::~ansicolor_sink() {
+    flusher_.stop();
+    fflush(target_file_);
+}
+
 template <typename Mutex>
 void ansicolor_sink<Mutex>::set_color(level color_level, string_view_t color) {
     std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
@@ -55,6 +59,19 @@ void ansicolor_sink<Mutex>::set_color_mode(color_mode mode) {
     }
 }
 
+template <typename Mutex>
+void ansicolor_sink<Mutex>::set_flush_interval(std::chrono::milliseconds interval) {
+    std::unique_ptr<details::periodic_worker> previous_timer;  // joined after unlocking, its callback locks
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    previous_timer = flusher_.set_interval(interval);
+}
+
+template <typename Mutex>
+bool ansicolor_sink<Mutex>::line_flush() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    return flusher_.line_flush();
+}
+
 template <typename Mutex>
 void ansicolor_sink<Mutex>::sink_it_(const details::log_msg &msg) {
     // Wrap the originally formatted message in color codes.
@@ -62,22 +79,23 @@ void ansicolor_sink<Mutex>::sink_it_(const details::log_msg &msg) {
 
     msg.color_range_start = 0;
     msg.color_range_end = 0;
-    memory_buf_t formatted;
-    base_sink<Mutex>::formatter_->format(msg, formatted);
+    formatted_.clear();
+    base_sink<Mutex>::formatter_->format(msg, formatted_);
+    const memory_buf_t *out = &formatted_;
     if (should_do_colors_ && msg.color_range_end > msg.color_range_start) {
-        // before color range
-        print_range_(formatted, 0, msg.color_range_start);
-        // in color range
-        print_ccode_(colors_.at(level_to_number(msg.log_level)));
-        print_range_(formatted, msg.color_range_start, msg.color_range_end);
-        print_ccode_(reset);
-        // after color range
-        print_range_(formatted, msg.color_range_end, formatted.size());
-    } else  // no color
-    {
-        print_range_(formatted, 0, formatted.size());
+        const auto &color = colors_.at(level_to_number(msg.log_level));
+        const char *data = formatted_.data();
+        colored_.clear();
+        // before color range, color code, in color range, reset, after color range
+        colored_.append(data, data + msg.color_range_start);
+        colored_.append(color.data(), color.data() + color.size());
+        colored_.append(data + msg.color_range_start, data + msg.color_range_end);
+        colored_.append(reset.data(), reset.data() + reset.size());
+        colored_.append(data + msg.color_range_end, data + formatted_.size());
+        out = &colored_;
     }
-    fflush(target_file_);
+    details::os::fwrite_bytes(out->data(), out->size(), target_file_);
+    flusher_.written(msg.time);
 }
 
 template <typename Mutex>
@@ -85,16 +103,6 @@ void ansicolor_sink<Mutex>::flush_() {
     fflush(target_file_);
 }
 
-template <typename Mutex>
-void ansicolor_sink<Mutex>::print_ccode_(const string_view_t color_code) {
-    details::os::fwrite_bytes(color_code.data(), color_code.size(), target_file_);
-}
-
-template <typename Mutex>
-void ansicolor_sink<Mutex>::print_range_(const memory_buf_t &formatted, size_t start, size_t end) {
-    details::os::fwrite_bytes(formatted.data() + start, end - start, target_file_);
-}
-
 template <typename Mutex>
 std::string ansicolor_sink<Mutex>::to_string_(const string_view_t sv) {
     return {sv.data(), sv.size()};
@@ -114,6 +122,9 @@ ansicolor_stderr_sink<Mutex>::ansicolor_stderr_sink(color_mode mode)
 }  // namespace spdlog
 
 // template instantiations
+template class SPDLOG_API spdlog::sinks::ansicolor_sink<std::mutex>;
+template class SPDLOG_API spdlog::sinks::ansicolor_sink<spdlog::details::null_mutex>;
+
 template class SPDLOG_API spdlog::sinks::ansicolor_stdout_sink<std::mutex>;
 template class SPDLOG_API spdlog::sinks::ansicolor_stdout_sink<spdlog::details::null_mutex>;
 
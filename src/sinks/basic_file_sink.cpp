@@ -9,8 +9,11 @@ namespace spdlog {
 namespace sinks {
 
 template <typename Mutex>
-basic_file_sink<Mutex>::basic_file_sink(const filename_t &filename, bool truncate, const file_event_handlers &event_handlers)
-    : file_helper_{event_handlers} {
+basic_file_sink<Mutex>::basic_file_sink(const filename_t &filename,
+                                        bool truncate,
+                                        const file_event_handlers &event_handlers,
+                                        size_t write_buffer_size)
+    : file_helper_{event_handlers, write_buffer_size} {
     file_helper_.open(filename, truncate);
 }
 
@@ -19,11 +22,24 @@ const filename_t &basic_file_sink<Mutex>::filename() const {
     return file_helper_.filename();
 }
 
+template <typename Mutex>
+void basic_file_sink<Mutex>::set_sync_policy(const file_sync_policy &policy) {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    file_helper_.set_sync_policy(policy);
+}
+
+template <typename Mutex>
+void basic_file_sink<Mutex>::set_page_cache_mode(page_cache_mode mode) {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    file_helper_.set_page_cache_mode(mode);
+}
+
 template <typename Mutex>
 void basic_file_sink<Mutex>::sink_it_(const details::log_msg &msg) {
-    memory_buf_t formatted;
-    base_sink<Mutex>::formatter_->format(msg, formatted);
-    file_helper_.write(formatted);
+    formatted_.clear();
+    base_sink<Mutex>::formatter_->format(msg, formatted_);
+    file_helper_.write(formatted_);
+    file_helper_.sync_by_policy(msg.log_level);
 }
 
 template <typename Mutex>
@@ -0,0 +1,125 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "spdlog/sinks/buffered_sink.h"
+
+#include <exception>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include "spdlog/common.h"
+#include "spdlog/pattern_formatter.h"
+
+namespace spdlog {
+namespace sinks {
+
+template <typename Mutex>
+buffered_sink<Mutex>::buffered_sink(std::shared_ptr<sink> inner, buffered_sink_config config)
+    : inner_{std::move(inner)},
+      config_{config} {
+    if (!inner_) {
+        throw_spdlog_ex("buffered_sink: inner sink cannot be null");
+    }
+    inner_->set_formatter(std::make_unique<spdlog::pattern_formatter>("%v", pattern_time_type::local, ""));
+    buffer_.reserve(config_.max_bytes);
+    // the _st version isn't thread safe, so it can't be written from a timer thread
+    if (!std::is_same<Mutex, details::null_mutex>::value && config_.flush_interval.count() > 0) {
+        timer_ = std::make_unique<details::periodic_worker>([this] { on_timer_(); }, config_.flush_interval);
+    }
+}
+
+template <typename Mutex>
+buffered_sink<Mutex>::~buffered_sink() {
+    timer_.reset();
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    try {
+        write_buffer_();
+        inner_->flush();
+    } catch (...) {
+    }
+}
+
+template <typename Mutex>
+size_t buffered_sink<Mutex>::buffered_bytes() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    return buffer_.size();
+}
+
+template <typename Mutex>
+void buffered_sink<Mutex>::sink_it_(const details::log_msg &msg) {
+    check_error_();
+    if (buffer_.size() == 0) {
+        buffer_level_ = msg.log_level;
+        buffer_time_ = msg.time;
+    } else if (msg.log_level > buffer_level_) {
+        buffer_level_ = msg.log_level;
+    }
+    base_sink<Mutex>::formatter_->format(msg, buffer_);
+
+    if (msg.log_level >= config_.flush_level) {
+        write_buffer_();
+        inner_->flush();
+    } else if (buffer_.size() >= config_.max_bytes ||
+               (config_.flush_interval.count() > 0 && msg.time - buffer_time_ >= config_.flush_interval)) {
+        write_buffer_();
+    }
+}
+
+template <typename Mutex>
+void buffered_sink<Mutex>::flush_() {
+    check_error_();
+    write_buffer_();
+    inner_->flush();
+}
+
+template <typename Mutex>
+void buffered_sink<Mutex>::write_buffer_() {
+    if (buffer_.size() == 0) {
+        return;
+    }
+    details::log_msg batch{buffer_time_, source_loc{}, string_view_t{}, buffer_level_,
+                           string_view_t{buffer_.data(), buffer_.size()}};
+    // drop the buffer even if the inner sink throws, rather than failing again on every message
+    try {
+        inner_->log(batch);
+    } catch (...) {
+        buffer_.clear();
+        throw;
+    }
+    buffer_.clear();
+}
+
+template <typename Mutex>
+void buffered_sink<Mutex>::on_timer_() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    if (buffer_.size() == 0 || log_clock::now() - buffer_time_ < config_.flush_interval) {
+        return;
+    }
+    try {
+        write_buffer_();
+        inner_->flush();
+    } catch (const std::exception &ex) {
+        if (timer_error_.empty()) {
+            timer_error_ = ex.what();
+        }
+    } catch (...) {
+        if (timer_error_.empty()) {
+            timer_error_ = "Unknown exception in buffered_sink timer";
+        }
+    }
+}
+
+template <typename Mutex>
+void buffered_sink<Mutex>::check_error_() {
+    if (!timer_error_.empty()) {
+        throw_spdlog_ex(std::exchange(timer_error_, std::string{}));
+    }
+}
+
+}  // namespace sinks
+}  // namespace spdlog
+
+// template instantiations
+template class SPDLOG_API spdlog::sinks::buffered_sink<std::mutex>;
+template class SPDLOG_API spdlog::sinks::buffered_sink<spdlog::details::null_mutex>;
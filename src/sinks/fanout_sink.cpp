@@ -0,0 +1,161 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "spdlog/sinks/fanout_sink.h"
+
+#include <mutex>
+#include <utility>
+
+#include "spdlog/common.h"
+#include "spdlog/pattern_formatter.h"
+
+namespace spdlog {
+namespace sinks {
+
+template <typename Mutex>
+fanout_sink<Mutex>::child::child(std::shared_ptr<sink> child_sink, size_t queue_size)
+    : sink_ptr{std::move(child_sink)},
+      queue{queue_size} {}
+
+template <typename Mutex>
+fanout_sink<Mutex>::fanout_sink(std::vector<std::shared_ptr<sink>> sinks,
+                                size_t queue_size,
+                                async_overflow_policy overflow_policy)
+    : sinks_{std::move(sinks)},
+      overflow_policy_{overflow_policy} {
+    if (queue_size == 0) {
+        throw_spdlog_ex("fanout_sink: queue_size cannot be zero");
+    }
+    if (overflow_policy_ == async_overflow_policy::overrun_oldest) {
+        throw_spdlog_ex("fanout_sink: async_overflow_policy::overrun_oldest is not supported");
+    }
+    children_.reserve(sinks_.size());
+    try {
+        for (const auto &child_sink : sinks_) {
+            auto c = std::make_unique<child>(child_sink, queue_size);
+            c->thread = std::thread(&fanout_sink::writer_loop_, std::ref(*c));
+            children_.push_back(std::move(c));
+        }
+    } catch (...) {
+        for (auto &c : children_) {
+            enqueue_(*c, item_type::terminate, nullptr);
+            c->thread.join();
+        }
+        throw;
+    }
+}
+
+// write what's queued and stop the writer threads
+template <typename Mutex>
+fanout_sink<Mutex>::~fanout_sink() {
+    for (auto &c : children_) {
+        enqueue_(*c, item_type::terminate, nullptr);
+    }
+    for (auto &c : children_) {
+        c->thread.join();
+    }
+}
+
+template <typename Mutex>
+std::vector<fanout_stats> fanout_sink<Mutex>::stats() const {
+    std::vector<fanout_stats> result;
+    result.reserve(children_.size());
+    for (const auto &c : children_) {
+        fanout_stats s;
+        s.pending = c->queue.size();
+        s.written = c->written.load(std::memory_order_relaxed);
+        s.dropped = c->dropped.load(std::memory_order_relaxed);
+        s.failed = c->failed.load(std::memory_order_relaxed);
+        result.push_back(s);
+    }
+    return result;
+}
+
+template <typename Mutex>
+void fanout_sink<Mutex>::wait_idle() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    for (auto &c : children_) {
+        c->queue.wait_empty();
+    }
+}
+
+template <typename Mutex>
+void fanout_sink<Mutex>::sink_it_(const details::log_msg &msg) {
+    for (auto &c : children_) {
+        if (c->sink_ptr->should_log(msg.log_level)) {
+            enqueue_(*c, item_type::log, &msg);
+        }
+    }
+}
+
+template <typename Mutex>
+void fanout_sink<Mutex>::flush_() {
+    for (auto &c : children_) {
+        enqueue_(*c, item_type::flush, nullptr);
+    }
+}
+
+template <typename Mutex>
+void fanout_sink<Mutex>::set_pattern_(const std::string &pattern) {
+    set_formatter_(std::make_unique<spdlog::pattern_formatter>(pattern));
+}
+
+template <typename Mutex>
+void fanout_sink<Mutex>::set_formatter_(std::unique_ptr<spdlog::formatter> sink_formatter) {
+    base_sink<Mutex>::formatter_ = std::move(sink_formatter);
+    for (auto &child_sink : sinks_) {
+        child_sink->set_formatter(base_sink<Mutex>::formatter_->clone());
+    }
+}
+
+// called under the sink's mutex (or by the constructor/destructor), so each queue has a single producer
+template <typename Mutex>
+bool fanout_sink<Mutex>::enqueue_(child &c, item_type type, const details::log_msg *msg) {
+    item *slot = nullptr;
+    if (overflow_policy_ == async_overflow_policy::block || type == item_type::terminate) {
+        slot = &c.queue.write_slot();
+    } else {
+        slot = c.queue.try_write_slot();
+        if (slot == nullptr) {
+            if (type == item_type::log) {
+                c.dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+            return false;
+        }
+    }
+    slot->type = type;
+    if (msg != nullptr) {
+        slot->msg.assign(*msg);
+    }
+    c.queue.push();
+    return true;
+}
+
+template <typename Mutex>
+void fanout_sink<Mutex>::writer_loop_(child &c) {
+    for (;;) {
+        item &it = c.queue.wait_front();
+        if (it.type == item_type::terminate) {
+            c.queue.pop();
+            return;
+        }
+        try {
+            if (it.type == item_type::log) {
+                c.sink_ptr->log(it.msg);
+                c.written.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                c.sink_ptr->flush();
+            }
+        } catch (...) {
+            c.failed.fetch_add(1, std::memory_order_relaxed);
+        }
+        c.queue.pop();
+    }
+}
+
+}  // namespace sinks
+}  // namespace spdlog
+
+// template instantiations
+template class SPDLOG_API spdlog::sinks::fanout_sink<std::mutex>;
+template class SPDLOG_API spdlog::sinks::fanout_sink<spdlog::details::null_mutex>;
@@ -0,0 +1,213 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "spdlog/sinks/mmap_file_sink.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+
+#include "spdlog/common.h"
+#include "spdlog/details/os.h"
+#include "spdlog/sinks/rotating_file_sink.h"
+
+namespace spdlog {
+namespace sinks {
+
+static std::size_t page_size() {
+    static const auto size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+template <typename Mutex>
+mmap_file_sink<Mutex>::mmap_file_sink(filename_t base_filename,
+                                      std::size_t max_size,
+                                      std::size_t max_files,
+                                      const file_event_handlers &event_handlers,
+                                      std::size_t map_size)
+    : base_filename_(std::move(base_filename)),
+      max_size_(max_size),
+      max_files_(max_files),
+      map_size_((map_size + page_size() - 1) / page_size() * page_size()),
+      file_helper_{event_handlers} {
+    if (max_size == 0) {
+        throw_spdlog_ex("mmap_file_sink constructor: max_size arg cannot be zero");
+    }
+    if (map_size == 0) {
+        throw_spdlog_ex("mmap_file_sink constructor: map_size arg cannot be zero");
+    }
+    if (max_files > 200000) {
+        throw_spdlog_ex("mmap_file_sink constructor: max_files arg cannot exceed 200000");
+    }
+    open_(false);
+}
+
+template <typename Mutex>
+mmap_file_sink<Mutex>::~mmap_file_sink() {
+    try {
+        close_();
+    } catch (...) {
+    }
+}
+
+template <typename Mutex>
+filename_t mmap_file_sink<Mutex>::filename() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    return file_helper_.filename();
+}
+
+template <typename Mutex>
+void mmap_file_sink<Mutex>::rotate_now() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    rotate_();
+}
+
+template <typename Mutex>
+void mmap_file_sink<Mutex>::sync() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    if (map_ != nullptr && ::msync(map_, map_size_, MS_SYNC) != 0) {
+        throw_spdlog_ex("mmap_file_sink: msync failed " + details::os::filename_to_str(file_helper_.filename()), errno);
+    }
+    // previous windows were unmapped but their pages may still be dirty
+    if (fd_ >= 0 && ::fsync(fd_) != 0) {
+        throw_spdlog_ex("Failed to fsync file " + details::os::filename_to_str(file_helper_.filename()), errno);
+    }
+}
+
+template <typename Mutex>
+void mmap_file_sink<Mutex>::sink_it_(const details::log_msg &msg) {
+    formatted_.clear();
+    base_sink<Mutex>::formatter_->format(msg, formatted_);
+    if (size_ + formatted_.size() > max_size_ && size_ > 0) {
+        rotate_();
+    }
+    write_(formatted_.data(), formatted_.size());
+}
+
+// start writing back the dirty pages of the current window
+template <typename Mutex>
+void mmap_file_sink<Mutex>::flush_() {
+    if (map_ != nullptr && ::msync(map_, map_size_, MS_ASYNC) != 0) {
+        throw_spdlog_ex("mmap_file_sink: msync failed " + details::os::filename_to_str(file_helper_.filename()), errno);
+    }
+}
+
+template <typename Mutex>
+void mmap_file_sink<Mutex>::open_(bool truncate) {
+    file_helper_.open(base_filename_, truncate);
+    file_helper_.flush();  // whatever the after_open handler wrote
+
+    // the FILE* of file_helper is write only - map through our own descriptor
+    fd_ = ::open(base_filename_.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd_ < 0) {
+        throw_spdlog_ex("mmap_file_sink: failed opening file " + details::os::filename_to_str(base_filename_), errno);
+    }
+    size_ = reserved_ = file_helper_.size();
+    map_at_(size_);
+}
+
+// unmap, truncate the file to its written size and close it
+template <typename Mutex>
+void mmap_file_sink<Mutex>::close_() {
+    unmap_();
+    if (fd_ >= 0) {
+        const int rv = ::ftruncate(fd_, static_cast<off_t>(size_));
+        ::close(fd_);
+        fd_ = -1;
+        if (rv != 0) {
+            file_helper_.close();
+            throw_spdlog_ex("mmap_file_sink: failed truncating file " + details::os::filename_to_str(base_filename_), errno);
+        }
+    }
+    file_helper_.close();
+}
+
+// map the window containing the given file offset, reserving file space for it if needed
+template <typename Mutex>
+void mmap_file_sink<Mutex>::map_at_(std::size_t offset) {
+    unmap_();
+    map_offset_ = offset - offset % page_size();
+    const std::size_t map_end = map_offset_ + map_size_;
+    if (map_end > reserved_) {
+        int rv = -1;
+#ifdef __linux__
+        // allocate the blocks so that writing to the mapping can't fail on a full disk (SIGBUS).
+        // a full disk is an error: only extend the file without blocks if fallocate is not supported.
+        rv = ::fallocate(fd_, 0, static_cast<off_t>(reserved_), static_cast<off_t>(map_end - reserved_));
+        if (rv != 0 && (errno == EOPNOTSUPP || errno == ENOSYS || errno == EINVAL)) {
+            rv = ::ftruncate(fd_, static_cast<off_t>(map_end));
+        }
+#else
+        rv = ::ftruncate(fd_, static_cast<off_t>(map_end));
+#endif
+        if (rv != 0) {
+            throw_spdlog_ex("mmap_file_sink: failed extending file " + details::os::filename_to_str(base_filename_), errno);
+        }
+        reserved_ = map_end;
+    }
+
+    void *map = ::mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, static_cast<off_t>(map_offset_));
+    if (map == MAP_FAILED) {
+        throw_spdlog_ex("mmap_file_sink: mmap failed " + details::os::filename_to_str(base_filename_), errno);
+    }
+    map_ = static_cast<char *>(map);
+}
+
+template <typename Mutex>
+void mmap_file_sink<Mutex>::unmap_() {
+    if (map_ != nullptr) {
+        ::munmap(map_, map_size_);
+        map_ = nullptr;
+    }
+}
+
+template <typename Mutex>
+void mmap_file_sink<Mutex>::write_(const char *data, std::size_t size) {
+    while (size > 0) {
+        if (map_ == nullptr || size_ >= map_offset_ + map_size_) {
+            map_at_(size_);
+        }
+        const std::size_t pos = size_ - map_offset_;
+        const std::size_t n = (std::min)(size, map_size_ - pos);
+        std::memcpy(map_ + pos, data, n);
+        size_ += n;
+        data += n;
+        size -= n;
+    }
+}
+
+template <typename Mutex>
+void mmap_file_sink<Mutex>::rotate_() {
+    using details::os::filename_to_str;
+    using details::os::path_exists;
+
+    close_();
+    for (auto i = max_files_; i > 0; --i) {
+        filename_t src = rotating_file_sink_st::calc_filename(base_filename_, i - 1);
+        if (!path_exists(src)) {
+            continue;
+        }
+        filename_t target = rotating_file_sink_st::calc_filename(base_filename_, i);
+        if (!details::os::rename(src, target)) {
+            // retry after a small delay (see rotating_file_sink)
+            details::os::sleep_for_millis(100);
+            if (!details::os::rename(src, target)) {
+                open_(true);  // truncate the log file anyway to prevent it to grow beyond its limit
+                throw_spdlog_ex("mmap_file_sink: failed renaming " + filename_to_str(src) + " to " + filename_to_str(target), errno);
+            }
+        }
+    }
+    open_(true);
+}
+
+}  // namespace sinks
+}  // namespace spdlog
+
+// template instantiations
+template class SPDLOG_API spdlog::sinks::mmap_file_sink<std::mutex>;
+template class SPDLOG_API spdlog::sinks::mmap_file_sink<spdlog::details::null_mutex>;
@@ -3,11 +3,17 @@
 
 #include "spdlog/sinks/rotating_file_sink.h"
 
+#include <algorithm>
 #include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
 #include <mutex>
 #include <sstream>
 #include <string>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 #include "spdlog/common.h"
 #include "spdlog/details/file_helper.h"
@@ -21,10 +27,12 @@ rotating_file_sink<Mutex>::rotating_file_sink(filename_t base_filename,
                                               std::size_t max_size,
                                               std::size_t max_files,
                                               bool rotate_on_open,
-                                              const file_event_handlers &event_handlers)
+                                              const file_event_handlers &event_handlers,
+                                              rotation_naming naming)
     : base_filename_(std::move(base_filename)),
       max_size_(max_size),
       max_files_(max_files),
+      naming_(naming),
       file_helper_{event_handlers} {
     if (max_size == 0) {
         throw_spdlog_ex("rotating sink constructor: max_size arg cannot be zero");
@@ -33,11 +41,14 @@ rotating_file_sink<Mutex>::rotating_file_sink(filename_t base_filename,
     if (max_files > 200000) {
         throw_spdlog_ex("rotating sink constructor: max_files arg cannot exceed 200000");
     }
-    file_helper_.open(calc_filename(base_filename_, 0));
-    current_size_ = file_helper_.size();  // expensive. called only once
-    if (rotate_on_open && current_size_ > 0) {
+    if (naming_ == rotation_naming::monotonic) {
+        open_index_((std::max)(scan_indices_(), std::size_t{1}));
+    } else {
+        recover_staging_files_();
+        file_helper_.open(calc_filename(base_filename_, 0));
+    }
+    if (rotate_on_open && file_helper_.size() > 0) {
         rotate_();
-        current_size_ = 0;
     }
 }
 
@@ -65,27 +76,121 @@ filename_t rotating_file_sink<Mutex>::filename() {
 
 template <typename Mutex>
 void rotating_file_sink<Mutex>::rotate_now() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
     rotate_();
 }
 
 template <typename Mutex>
-void rotating_file_sink<Mutex>::sink_it_(const details::log_msg &msg) {
-    memory_buf_t formatted;
-    base_sink<Mutex>::formatter_->format(msg, formatted);
-    auto new_size = current_size_ + formatted.size();
+void rotating_file_sink<Mutex>::resync_size() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    file_helper_.resync();
+}
+
+template <typename Mutex>
+void rotating_file_sink<Mutex>::set_sync_policy(const file_sync_policy &policy) {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    file_helper_.set_sync_policy(policy);
+}
+
+template <typename Mutex>
+void rotating_file_sink<Mutex>::set_page_cache_mode(page_cache_mode mode) {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    file_helper_.set_page_cache_mode(mode);
+}
+
+template <typename Mutex>
+void rotating_file_sink<Mutex>::set_background_rotation(bool enabled) {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    worker_.reset();  // finishes the pending work
+    if (enabled) {
+        worker_ = std::make_unique<details::rotation_worker>();
+        worker_->prepare(file_helper_, next_filename_(), true);
+    } else {
+        compress_level_ = 0;  // compression_mode::rotated needs the worker
+    }
+}
 
-    // rotate if the new estimated file size exceeds max size.
-    // rotate only if the real size > 0 to better deal with full disk (see issue #2261).
-    // we only check the real size when new_size > max_size_ because it is relatively expensive.
-    if (new_size > max_size_) {
-        file_helper_.flush();
-        if (file_helper_.size() > 0) {
-            rotate_();
-            new_size = formatted.size();
+template <typename Mutex>
+void rotating_file_sink<Mutex>::set_compression(const file_compression &compression) {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    if (compression.mode != compression_mode::none && !details::gzip_available()) {
+        throw_spdlog_ex("rotating_file_sink: gzip compression is not available - spdlog was built without SPDLOG_ZLIB");
+    }
+    file_helper_.set_compression(compression.mode == compression_mode::live ? compression.level : 0);
+    compress_level_ = 0;
+    if (compression.mode == compression_mode::rotated) {
+        if (!worker_) {
+            worker_ = std::make_unique<details::rotation_worker>();
+            worker_->prepare(file_helper_, next_filename_(), true);
         }
+        compress_level_ = compression.level;
+    }
+}
+
+template <typename Mutex>
+void rotating_file_sink<Mutex>::set_preallocation(bool enabled) {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    const bool background = worker_ != nullptr;
+    worker_.reset();  // the prepared file must be opened with the new setting
+    preallocate_ = enabled;
+    file_helper_.set_preallocate(enabled ? max_size_ : 0);
+    if (enabled || background) {
+        worker_ = std::make_unique<details::rotation_worker>();
+        worker_->prepare(file_helper_, next_filename_(), true);
+    }
+}
+
+template <typename Mutex>
+void rotating_file_sink<Mutex>::set_disk_quota(std::shared_ptr<disk_quota> quota, quota_priority priority) {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    // the shifted files change names on every rotation, so they can't be tracked
+    if (quota && naming_ != rotation_naming::monotonic) {
+        throw_spdlog_ex("rotating_file_sink: disk quota requires rotation_naming::monotonic");
+    }
+    quota_.reset();
+    if (!quota) {
+        return;
+    }
+    quota_ = std::make_unique<details::quota_client>(std::move(quota), priority);
+    for (std::size_t index = index_ > max_files_ ? index_ - max_files_ : 1; index < index_; index++) {
+        quota_->add_existing(calc_filename(base_filename_, index));
+    }
+    quota_->set_current(file_helper_.filename(), file_helper_.size());
+}
+
+template <typename Mutex>
+void rotating_file_sink<Mutex>::wait_background_rotation() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    if (worker_) {
+        worker_->wait_idle();
+    }
+}
+
+template <typename Mutex>
+rotation_stats rotating_file_sink<Mutex>::get_rotation_stats() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    return rotation_stats_;
+}
+
+template <typename Mutex>
+void rotating_file_sink<Mutex>::sink_it_(const details::log_msg &msg) {
+    if (quota_ && !quota_->sample()) {
+        return;
+    }
+    formatted_.clear();
+    base_sink<Mutex>::formatter_->format(msg, formatted_);
+
+    // rotate if the new file size exceeds max size. the size is tracked by file_helper_, so this costs no syscall.
+    // rotate only if the file is not empty, so a message larger than max_size doesn't rotate forever (see issue #2261).
+    const auto size = file_helper_.size();
+    if (size > 0 && size + formatted_.size() > max_size_) {
+        rotate_();
+    }
+    file_helper_.write(formatted_);
+    file_helper_.sync_by_policy(msg.log_level);
+    if (quota_) {
+        quota_->written(formatted_.size());
     }
-    file_helper_.write(formatted);
-    current_size_ = new_size;
 }
 
 template <typename Mutex>
@@ -93,16 +198,47 @@ void rotating_file_sink<Mutex>::flush_() {
     file_helper_.flush();
 }
 
+template <typename Mutex>
+void rotating_file_sink<Mutex>::rotate_() {
+    const auto start = std::chrono::steady_clock::now();
+    if (worker_) {
+        rotate_background_();
+    } else {
+        rotate_files_();
+    }
+    rotation_stats_.add(std::chrono::steady_clock::now() - start);
+    if (quota_) {
+        quota_->set_current(file_helper_.filename(), file_helper_.size());
+        if (index_ > max_files_ + 1) {
+            quota_->removed(calc_filename(base_filename_, index_ - max_files_ - 1));
+        }
+    }
+    if (worker_) {
+        worker_->check_error();
+    }
+}
+
 // Rotate files:
 // log.txt -> log.1.txt
 // log.1.txt -> log.2.txt
 // log.2.txt -> log.3.txt
 // log.3.txt -> delete
 template <typename Mutex>
-void rotating_file_sink<Mutex>::rotate_() {
+void rotating_file_sink<Mutex>::rotate_files_() {
     using details::os::filename_to_str;
     using details::os::path_exists;
 
+    if (naming_ == rotation_naming::monotonic) {
+        file_helper_.close();
+        open_index_(index_ + 1);
+        // the files of previous runs beyond max_files were deleted by scan_indices_(),
+        // so deleting the one that just fell out of the window is enough.
+        if (index_ > max_files_ + 1) {
+            details::os::remove_if_exists(calc_filename(base_filename_, index_ - max_files_ - 1));
+        }
+        return;
+    }
+
     file_helper_.close();
     for (auto i = max_files_; i > 0; --i) {
         filename_t src = calc_filename(base_filename_, i - 1);
@@ -120,7 +256,6 @@ void rotating_file_sink<Mutex>::rotate_() {
             if (!rename_file_(src, target)) {
                 file_helper_.reopen(true);  // truncate the log file anyway to prevent it
                                             // to grow beyond its limit!
-                current_size_ = 0;
                 throw_spdlog_ex("rotating_file_sink: failed renaming " + filename_to_str(src) + " to " + filename_to_str(target),
                                 errno);
             }
@@ -129,6 +264,243 @@ void rotating_file_sink<Mutex>::rotate_() {
     file_helper_.reopen(true);
 }
 
+template <typename Mutex>
+void rotating_file_sink<Mutex>::rotate_background_() {
+    using details::os::filename_to_str;
+
+    const filename_t next = next_filename_();
+    std::FILE *fp = worker_->take_prepared(next);
+    if (naming_ == rotation_naming::monotonic) {
+        const filename_t previous = file_helper_.filename();
+        if (fp != nullptr) {
+            file_helper_.adopt(fp, next);
+        } else {
+            // the oldest file may be on its way to become the next one - wait for it and overwrite it
+            if (preallocate_) {
+                worker_->wait_idle();
+            }
+            file_helper_.open(next, preallocate_);
+        }
+        index_++;
+        const std::size_t old_index = index_ > max_files_ + 1 ? index_ - max_files_ - 1 : 0;
+        // the oldest file becomes the next one, which is prepared after this task
+        const filename_t reuse_as = preallocate_ && compress_level_ == 0 ? next_filename_() : filename_t{};
+        worker_->post([base_filename = base_filename_, next, previous, old_index, reuse_as, level = compress_level_] {
+            details::os::create_symlink(next.filename(), base_filename);
+            if (level > 0) {
+                details::gzip_file(previous, filename_t(previous) += SPDLOG_FILENAME_T(".gz"), level);
+                details::os::remove(previous);
+            }
+            if (old_index > 0) {
+                const filename_t old_filename = calc_filename(base_filename, old_index);
+                if (!reuse_as.empty() && details::os::path_exists(old_filename)) {
+                    rename_file_(old_filename, reuse_as);
+                }
+                details::os::remove_if_exists(old_filename);
+                details::os::remove_if_exists(filename_t(old_filename) += SPDLOG_FILENAME_T(".gz"));
+            }
+        });
+    } else {
+        // rename the current file out of the way. the rest of the chain is shifted in the background.
+        file_helper_.close();
+        filename_t rotated = base_filename_;
+        if (max_files_ > 0) {
+            rotated += SPDLOG_FILENAME_T(".rotated.");
+            rotated += std::to_string(++rotated_seq_);
+            if (!rename_file_(base_filename_, rotated)) {
+                if (fp != nullptr) {
+                    std::fclose(fp);
+                }
+                file_helper_.reopen(true);  // truncate the log file anyway to prevent it to grow beyond its limit!
+                throw_spdlog_ex("rotating_file_sink: failed renaming " + filename_to_str(base_filename_) + " to " +
+                                    filename_to_str(rotated),
+                                errno);
+            }
+        }
+        if (fp != nullptr && rename_file_(next, base_filename_)) {
+            file_helper_.adopt(fp, base_filename_);
+        } else {
+            if (fp != nullptr) {
+                std::fclose(fp);
+            }
+            file_helper_.open(base_filename_, true);
+        }
+        if (max_files_ > 0) {
+            // the oldest file becomes the next one, which is prepared after this task
+            const filename_t reuse_as = preallocate_ && compress_level_ == 0 ? next_filename_() : filename_t{};
+            worker_->post([base_filename = base_filename_, max_files = max_files_, rotated, level = compress_level_, reuse_as] {
+                shift_files_(base_filename, max_files, rotated, level, reuse_as);
+            });
+        }
+    }
+    worker_->prepare(file_helper_, next_filename_(), true);
+}
+
+template <typename Mutex>
+filename_t rotating_file_sink<Mutex>::next_filename_() const {
+    if (naming_ == rotation_naming::monotonic) {
+        return calc_filename(base_filename_, index_ + 1);
+    }
+    filename_t next = base_filename_;
+    next += SPDLOG_FILENAME_T(".next");
+    return next;
+}
+
+template <typename Mutex>
+void rotating_file_sink<Mutex>::shift_files_(const filename_t &base_filename,
+                                             std::size_t max_files,
+                                             const filename_t &rotated,
+                                             int compress_level,
+                                             const filename_t &reuse_as) {
+    using details::os::filename_to_str;
+
+    // the rotated files are compressed: log.1.txt.gz, log.2.txt.gz ..
+    auto calc = [&](std::size_t index) {
+        filename_t filename = calc_filename(base_filename, index);
+        if (compress_level > 0) {
+            filename += SPDLOG_FILENAME_T(".gz");
+        }
+        return filename;
+    };
+
+    auto rename_or_throw = [](const filename_t &src, const filename_t &target) {
+        // retry after a small delay (see rotate_files_())
+        if (!rename_file_(src, target)) {
+            details::os::sleep_for_millis(100);
+            if (!rename_file_(src, target)) {
+                throw_spdlog_ex("rotating_file_sink: failed renaming " + filename_to_str(src) + " to " + filename_to_str(target),
+                                errno);
+            }
+        }
+    };
+    // reuse the oldest file rather than letting the shift below replace it
+    if (!reuse_as.empty() && details::os::path_exists(calc(max_files))) {
+        rename_or_throw(calc(max_files), reuse_as);
+    }
+    for (auto i = max_files; i > 1; --i) {
+        filename_t src = calc(i - 1);
+        if (details::os::path_exists(src)) {
+            rename_or_throw(src, calc(i));
+        }
+    }
+    if (compress_level > 0) {
+        details::gzip_file(rotated, calc(1), compress_level);
+        details::os::remove(rotated);
+    } else {
+        rename_or_throw(rotated, calc(1));
+    }
+}
+
+template <typename Mutex>
+void rotating_file_sink<Mutex>::recover_staging_files_() {
+    using string_type = filename_t::string_type;
+    const string_type base = base_filename_.filename().native();
+    const string_type rotated_prefix = base + filename_t(SPDLOG_FILENAME_T(".rotated.")).native();
+    const string_type next = base + filename_t(SPDLOG_FILENAME_T(".next")).native();
+
+    auto dir = details::os::dir_name(base_filename_);
+    if (dir.empty()) {
+        dir = SPDLOG_FILENAME_T(".");
+    }
+    std::vector<std::pair<std::size_t, filename_t>> rotated;  // sequence number, file
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        const string_type name = it->path().filename().native();
+        if (name == next) {
+            // only the empty file prepared for the next rotation. keep anything written to it.
+            if (std::filesystem::file_size(it->path(), ec) == 0 && !ec) {
+                details::os::remove_if_exists(it->path());
+            }
+            ec.clear();
+            continue;
+        }
+        if (name.size() <= rotated_prefix.size() || name.compare(0, rotated_prefix.size(), rotated_prefix) != 0) {
+            continue;
+        }
+        std::size_t seq = 0;
+        bool valid = true;
+        for (auto c = name.begin() + static_cast<std::ptrdiff_t>(rotated_prefix.size()); c != name.end(); ++c) {
+            if (*c < '0' || *c > '9') {
+                valid = false;
+                break;
+            }
+            seq = seq * 10 + static_cast<std::size_t>(*c - '0');
+        }
+        if (valid) {
+            rotated.emplace_back(seq, it->path());
+        }
+    }
+    // without a chain to shift them into, they are left in place
+    if (max_files_ == 0) {
+        return;
+    }
+    // oldest first, so the last rotated file ends up as log.1.txt
+    std::sort(rotated.begin(), rotated.end());
+    for (const auto &file : rotated) {
+        shift_files_(base_filename_, max_files_, file.second, 0, filename_t{});
+    }
+}
+
+template <typename Mutex>
+void rotating_file_sink<Mutex>::open_index_(std::size_t index) {
+    const filename_t filename = calc_filename(base_filename_, index);
+    file_helper_.open(filename);
+    index_ = index;
+    // relative target, so the log directory can be moved. failure (e.g. no privilege on windows) is not an error.
+    details::os::create_symlink(filename.filename(), base_filename_);
+}
+
+template <typename Mutex>
+std::size_t rotating_file_sink<Mutex>::scan_indices_() {
+    using string_type = filename_t::string_type;
+    filename_t basename;
+    filename_t ext;
+    std::tie(basename, ext) = details::os::split_by_extension(base_filename_);
+    const string_type prefix = basename.filename().native() + filename_t::value_type('.');
+    const string_type &suffix = ext.native();
+    const string_type gz_suffix = filename_t(SPDLOG_FILENAME_T(".gz")).native();
+
+    std::vector<std::size_t> indices;
+    auto dir = details::os::dir_name(base_filename_);
+    if (dir.empty()) {
+        dir = SPDLOG_FILENAME_T(".");
+    }
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        string_type name = it->path().filename().native();
+        if (name.size() > gz_suffix.size() && name.compare(name.size() - gz_suffix.size(), gz_suffix.size(), gz_suffix) == 0) {
+            name.resize(name.size() - gz_suffix.size());  // compressed rotated file
+        }
+        if (name.size() <= prefix.size() + suffix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+            continue;
+        }
+        const auto digits = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+        const auto is_digit = [](filename_t::value_type c) { return c >= '0' && c <= '9'; };
+        if (digits.size() > 18 || !std::all_of(digits.begin(), digits.end(), is_digit)) {
+            continue;
+        }
+        indices.push_back(static_cast<std::size_t>(std::stoull(digits)));
+    }
+    const std::size_t last = indices.empty() ? 0 : *std::max_element(indices.begin(), indices.end());
+
+    // a regular file under the base name is left from the shift naming - keep it as the newest file
+    std::size_t next = last;
+    if (std::filesystem::is_regular_file(std::filesystem::symlink_status(base_filename_, ec)) &&
+        details::os::rename(base_filename_, calc_filename(base_filename_, last + 1))) {
+        next = last + 1;
+        indices.push_back(next);
+    }
+    for (auto index : indices) {
+        if (index + max_files_ < next) {
+            const filename_t filename = calc_filename(base_filename_, index);
+            details::os::remove_if_exists(filename);
+            details::os::remove_if_exists(filename_t(filename) += SPDLOG_FILENAME_T(".gz"));
+        }
+    }
+    return next;
+}
+
 // delete the target if exists, and rename the src file  to target
 // return true on success, false otherwise.
 template <typename Mutex>
@@ -9,6 +9,13 @@ bool spdlog::sinks::sink::should_log(spdlog::level msg_level) const {
     return msg_level >= level_.load(std::memory_order_relaxed);
 }
 
-void spdlog::sinks::sink::set_level(level level) { level_.store(level, std::memory_order_relaxed); }
+void spdlog::sinks::sink::set_level(level level) {
+    level_.store(level, std::memory_order_relaxed);
+    levels_changed();
+}
 
 spdlog::level spdlog::sinks::sink::log_level() const { return level_.load(std::memory_order_relaxed); }
+
+std::atomic<uint32_t> spdlog::sinks::sink::levels_version_{0};
+
+void spdlog::sinks::sink::levels_changed() noexcept { levels_version_.fetch_add(1, std::memory_order_release); }
@@ -28,7 +28,12 @@ namespace sinks {
 
 template <typename Mutex>
 stdout_sink_base<Mutex>::stdout_sink_base(FILE *file)
-    : file_(file) {
+    : file_(file),
+#ifdef _WIN32
+      flusher_(file, nullptr) {  // WriteFile() isn't buffered
+#else
+      flusher_(file, details::console_flusher::locked_flush(base_sink<Mutex>::mutex_, file)) {
+#endif  // _WIN32
 #ifdef _WIN32
     // get windows handle from the FILE* object
 
@@ -43,6 +48,25 @@ stdout_sink_base<Mutex>::stdout_sink_base(FILE *file)
 #endif  // _WIN32
 }
 
+template <typename Mutex>
+stdout_sink_base<Mutex>::~stdout_sink_base() {
+    flusher_.stop();
+    ::fflush(file_);
+}
+
+template <typename Mutex>
+void stdout_sink_base<Mutex>::set_flush_interval(std::chrono::milliseconds interval) {
+    std::unique_ptr<details::periodic_worker> previous_timer;  // joined after unlocking, its callback locks
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    previous_timer = flusher_.set_interval(interval);
+}
+
+template <typename Mutex>
+bool stdout_sink_base<Mutex>::line_flush() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    return flusher_.line_flush();
+}
+
 template <typename Mutex>
 void stdout_sink_base<Mutex>::sink_it_(const details::log_msg &msg) {
 #ifdef _WIN32
@@ -62,8 +86,8 @@ void stdout_sink_base<Mutex>::sink_it_(const details::log_msg &msg) {
     memory_buf_t formatted;
     base_sink<Mutex>::formatter_->format(msg, formatted);
     details::os::fwrite_bytes(formatted.data(), formatted.size(), file_);
-#endif                // _WIN32
-    ::fflush(file_);  // flush every line to terminal
+#endif  // _WIN32
+    flusher_.written(msg.time);
 }
 
 template <typename Mutex>
@@ -0,0 +1,378 @@
+// Copyright(c) 2015-present, Gabi Melman & spdlog contributors.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "spdlog/sinks/uring_file_sink.h"
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "spdlog/common.h"
+#include "spdlog/details/os.h"
+
+namespace spdlog {
+namespace details {
+
+// Minimal io_uring wrapper using the raw syscalls (no liburing dependency).
+// Single threaded - used under the sink's mutex.
+class uring {
+public:
+    struct completion {
+        std::uint64_t id;
+        int result;
+    };
+
+    // return nullptr if io_uring is not available
+    static std::unique_ptr<uring> create(unsigned entries) {
+        io_uring_params params{};
+        const int ring_fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (ring_fd < 0) {
+            return nullptr;
+        }
+        std::unique_ptr<uring> ring{new uring(ring_fd)};
+        if (!ring->map_(params)) {
+            return nullptr;
+        }
+        return ring;
+    }
+
+    ~uring() {
+        if (sqes_ != MAP_FAILED) {
+            ::munmap(sqes_, sqes_len_);
+        }
+        if (cq_ptr_ != MAP_FAILED && cq_ptr_ != sq_ptr_) {
+            ::munmap(cq_ptr_, cq_len_);
+        }
+        if (sq_ptr_ != MAP_FAILED) {
+            ::munmap(sq_ptr_, sq_len_);
+        }
+        ::close(ring_fd_);
+    }
+
+    uring(const uring &) = delete;
+    uring &operator=(const uring &) = delete;
+
+    // submit write of the given iovec (which must stay valid until completion) at the given offset
+    bool submit_writev(int fd, const iovec *iov, std::uint64_t offset, std::uint64_t id) {
+        auto *sqe = next_sqe_();
+        sqe->opcode = IORING_OP_WRITEV;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<std::uint64_t>(iov);
+        sqe->len = 1;
+        sqe->off = offset;
+        sqe->user_data = id;
+        return submit_();
+    }
+
+    // submit fsync after all previously submitted writes complete
+    bool submit_fsync(int fd, std::uint64_t id) {
+        auto *sqe = next_sqe_();
+        sqe->opcode = IORING_OP_FSYNC;
+        sqe->flags = IOSQE_IO_DRAIN;
+        sqe->fd = fd;
+        sqe->user_data = id;
+        return submit_();
+    }
+
+    // wait for the next completion. return false on error.
+    bool wait(completion &result) {
+        for (;;) {
+            const unsigned head = *cq_head_;
+            const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+            if (head != tail) {
+                const auto &cqe = cqes_[head & *cq_mask_];
+                result = {cqe.user_data, cqe.res};
+                __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+            if (::syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR) {
+                return false;
+            }
+        }
+    }
+
+private:
+    explicit uring(int ring_fd)
+        : ring_fd_{ring_fd} {}
+
+    bool map_(const io_uring_params &params) {
+        sq_len_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_len_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_len_ = cq_len_ = (std::max)(sq_len_, cq_len_);
+        }
+        sq_ptr_ = ::mmap(nullptr, sq_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+        if (sq_ptr_ == MAP_FAILED) {
+            return false;
+        }
+        cq_ptr_ = single_mmap ? sq_ptr_
+                              : ::mmap(nullptr, cq_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                                       IORING_OFF_CQ_RING);
+        if (cq_ptr_ == MAP_FAILED) {
+            return false;
+        }
+        sqes_len_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = ::mmap(nullptr, sqes_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+        if (sqes_ == MAP_FAILED) {
+            return false;
+        }
+
+        auto *sq = static_cast<char *>(sq_ptr_);
+        sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        auto *cq = static_cast<char *>(cq_ptr_);
+        cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    // the sink never has more requests in flight than ring entries, so there is always a free sqe
+    io_uring_sqe *next_sqe_() {
+        const unsigned index = *sq_tail_ & *sq_mask_;
+        auto *sqe = static_cast<io_uring_sqe *>(sqes_) + index;
+        std::memset(sqe, 0, sizeof(*sqe));
+        sq_array_[index] = index;
+        return sqe;
+    }
+
+    bool submit_() {
+        __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+        for (;;) {
+            const auto rv = ::syscall(__NR_io_uring_enter, ring_fd_, 1, 0, 0, nullptr, 0);
+            if (rv >= 0) {
+                return true;
+            }
+            if (errno != EINTR) {
+                return false;
+            }
+        }
+    }
+
+    int ring_fd_;
+    void *sq_ptr_ = MAP_FAILED;
+    void *cq_ptr_ = MAP_FAILED;
+    void *sqes_ = MAP_FAILED;
+    size_t sq_len_ = 0;
+    size_t cq_len_ = 0;
+    size_t sqes_len_ = 0;
+    unsigned *sq_tail_ = nullptr;
+    unsigned *sq_mask_ = nullptr;
+    unsigned *sq_array_ = nullptr;
+    unsigned *cq_head_ = nullptr;
+    unsigned *cq_tail_ = nullptr;
+    unsigned *cq_mask_ = nullptr;
+    io_uring_cqe *cqes_ = nullptr;
+};
+
+}  // namespace details
+
+namespace sinks {
+
+static constexpr std::uint64_t fsync_request_id = ~std::uint64_t{0};
+
+template <typename Mutex>
+uring_file_sink<Mutex>::uring_file_sink(const filename_t &filename,
+                                        bool truncate,
+                                        const file_event_handlers &event_handlers,
+                                        size_t buffer_size,
+                                        size_t buffers_count)
+    : file_helper_{event_handlers},
+      buffer_size_{buffer_size} {
+    if (buffer_size == 0 || buffers_count == 0) {
+        throw_spdlog_ex("uring_file_sink: buffer_size and buffers_count must be greater than 0");
+    }
+    file_helper_.open(filename, truncate);
+    file_helper_.flush();  // whatever the after_open handler wrote
+
+    // own descriptor (without O_APPEND) so several writes can be in flight at explicit offsets
+    fd_ = ::open(filename.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        throw_spdlog_ex("uring_file_sink: failed opening file " + details::os::filename_to_str(filename), errno);
+    }
+    offset_ = file_helper_.size();
+
+    buffers_.resize(buffers_count);
+    for (auto &b : buffers_) {
+        b.data.reset(new char[buffer_size_]);
+    }
+    uring_ = details::uring::create(static_cast<unsigned>(buffers_count + 1));
+}
+
+template <typename Mutex>
+uring_file_sink<Mutex>::~uring_file_sink() {
+    close_();
+}
+
+template <typename Mutex>
+const filename_t &uring_file_sink<Mutex>::filename() const {
+    return file_helper_.filename();
+}
+
+template <typename Mutex>
+bool uring_file_sink<Mutex>::uring_enabled() const {
+    return uring_ != nullptr;
+}
+
+template <typename Mutex>
+void uring_file_sink<Mutex>::sync() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    flush_();
+    if (uring_) {
+        details::uring::completion completion{};
+        if (!uring_->submit_fsync(fd_, fsync_request_id) || !uring_->wait(completion)) {
+            throw_spdlog_ex("uring_file_sink: io_uring fsync failed", errno);
+        }
+        if (completion.result < 0) {
+            throw_spdlog_ex("Failed to fsync file " + details::os::filename_to_str(filename()), -completion.result);
+        }
+    } else if (::fsync(fd_) != 0) {
+        throw_spdlog_ex("Failed to fsync file " + details::os::filename_to_str(filename()), errno);
+    }
+}
+
+template <typename Mutex>
+void uring_file_sink<Mutex>::sink_it_(const details::log_msg &msg) {
+    formatted_.clear();
+    base_sink<Mutex>::formatter_->format(msg, formatted_);
+    const size_t msg_size = formatted_.size();
+
+    // too large for the buffers - write it directly, after everything before it
+    if (msg_size > buffer_size_) {
+        flush_();
+        write_at_(formatted_.data(), msg_size, offset_);
+        offset_ += msg_size;
+        return;
+    }
+    if (buffers_[current_].size + msg_size > buffer_size_) {
+        submit_current_();
+    }
+    auto &b = buffers_[current_];
+    std::memcpy(b.data.get() + b.size, formatted_.data(), msg_size);
+    b.size += msg_size;
+}
+
+template <typename Mutex>
+void uring_file_sink<Mutex>::flush_() {
+    submit_current_();
+    wait_all_();
+}
+
+// submit the current buffer and move on to the next one (waiting for it if still in flight)
+template <typename Mutex>
+void uring_file_sink<Mutex>::submit_current_() {
+    auto &b = buffers_[current_];
+    if (b.size == 0) {
+        return;
+    }
+    b.offset = offset_;
+    offset_ += b.size;
+    if (uring_) {
+        b.iov.iov_base = b.data.get();
+        b.iov.iov_len = b.size;
+        if (!uring_->submit_writev(fd_, &b.iov, b.offset, current_)) {
+            throw_spdlog_ex("uring_file_sink: io_uring submit failed", errno);
+        }
+        b.in_flight = true;
+        ++in_flight_;
+    } else {
+        write_at_(b.data.get(), b.size, b.offset);
+        b.size = 0;
+    }
+
+    current_ = (current_ + 1) % buffers_.size();
+    while (buffers_[current_].in_flight) {
+        wait_completion_();
+    }
+}
+
+template <typename Mutex>
+void uring_file_sink<Mutex>::wait_completion_() {
+    details::uring::completion completion{};
+    if (!uring_->wait(completion)) {
+        // the ring is unusable - give up on the requests in flight
+        const auto err = errno;
+        for (auto &b : buffers_) {
+            b.in_flight = false;
+            b.size = 0;
+        }
+        in_flight_ = 0;
+        throw_spdlog_ex("uring_file_sink: io_uring wait failed", err);
+    }
+    if (completion.id >= buffers_.size()) {
+        return;  // not a write
+    }
+    auto &b = buffers_[completion.id];
+    b.in_flight = false;
+    --in_flight_;
+    const size_t size = b.size;
+    b.size = 0;
+    if (completion.result < 0) {
+        throw_spdlog_ex("Failed writing to file " + details::os::filename_to_str(filename()), -completion.result);
+    }
+    // short write - write the rest synchronously
+    const auto written = static_cast<size_t>(completion.result);
+    if (written < size) {
+        write_at_(b.data.get() + written, size - written, b.offset + written);
+    }
+}
+
+template <typename Mutex>
+void uring_file_sink<Mutex>::wait_all_() {
+    while (in_flight_ > 0) {
+        wait_completion_();
+    }
+}
+
+template <typename Mutex>
+void uring_file_sink<Mutex>::write_at_(const char *data, size_t size, std::uint64_t offset) {
+    while (size > 0) {
+        const auto written = ::pwrite(fd_, data, size, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw_spdlog_ex("Failed writing to file " + details::os::filename_to_str(filename()), errno);
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+        offset += static_cast<std::uint64_t>(written);
+    }
+}
+
+// write everything left and close the file. errors are ignored since called by the destructor.
+template <typename Mutex>
+void uring_file_sink<Mutex>::close_() {
+    try {
+        flush_();
+    } catch (...) {
+        while (in_flight_ > 0) {
+            try {
+                wait_completion_();
+            } catch (...) {
+            }
+        }
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    file_helper_.close();
+}
+
+}  // namespace sinks
+}  // namespace spdlog
+
+// template instantiations
+template class SPDLOG_API spdlog::sinks::uring_file_sink<std::mutex>;
+template class SPDLOG_API spdlog::sinks::uring_file_sink<spdlog::details::null_mutex>;
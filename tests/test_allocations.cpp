@@ -0,0 +1,247 @@
+/*
+ * This content is released under the MIT License as specified in
+ * https://raw.githubusercontent.com/gabime/spdlog/v2.x/LICENSE
+ */
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <new>
+
+#ifdef SPDLOG_MEMORY_RESOURCE
+    #include <memory_resource>
+#endif
+
+#include "includes.h"
+#include "spdlog/mdc.h"
+#include "spdlog/sinks/basic_file_sink.h"
+#include "spdlog/sinks/ringbuffer_sink.h"
+#include "spdlog/sinks/rotating_file_sink.h"
+
+// Count heap allocations (from all threads) by replacing the global operator new/delete.
+// Used to verify that logging doesn't allocate per message once warmed up.
+// Built as its own executable (spdlog-alloc-tests), so the replacements don't affect the other tests.
+static std::atomic<size_t> allocations_counter{0};
+
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmismatched-new-delete"  // malloc/free based replacements
+#endif
+
+void *operator new(std::size_t size) {
+    allocations_counter.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) { return ::operator new(size); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    allocations_counter.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept { return ::operator new(size, tag); }
+
+// aligned versions (used by std::pmr::new_delete_resource)
+static void *aligned_malloc(std::size_t size, std::size_t alignment) {
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+}
+
+static void aligned_free(void *p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    allocations_counter.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = aligned_malloc(size == 0 ? 1 : size, static_cast<std::size_t>(alignment))) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) { return ::operator new(size, alignment); }
+
+void operator delete(void *p, std::align_val_t) noexcept { aligned_free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { aligned_free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { aligned_free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { aligned_free(p); }
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { ::operator delete(p); }
+void operator delete(void *p, std::size_t) noexcept { ::operator delete(p); }
+void operator delete[](void *p, std::size_t) noexcept { ::operator delete(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { ::operator delete(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { ::operator delete(p); }
+
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
+
+#define TEST_FILENAME "test_logs/alloc_test.log"
+
+static const size_t warmup_messages = 100;
+static const size_t measured_messages = 1000;
+
+// log the same kind of messages the tests measure (all fit in memory_buf_t's inline storage)
+static void log_messages(spdlog::logger &logger, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        logger.info("Hello message #{} {} {:.3f}", i, "some text", 3.14 * static_cast<double>(i));
+        logger.debug("filtered message #{}", i);
+        logger.warn("fields", spdlog::kv("id", i), spdlog::kv("name", "value"));
+    }
+}
+
+// number of allocations made by logging after warming up.
+// wait_idle() should return once all logged messages were processed (for async loggers).
+static size_t count_allocations(spdlog::logger &logger, const std::function<void()> &wait_idle = [] {}) {
+    log_messages(logger, warmup_messages);
+    logger.flush();
+    wait_idle();
+    auto before = allocations_counter.load();
+    log_messages(logger, measured_messages);
+    logger.flush();
+    wait_idle();
+    return allocations_counter.load() - before;
+}
+
+TEST_CASE("counting operator new", "[allocations]") {
+    auto before = allocations_counter.load();
+    auto p = std::make_unique<int>(1);
+    REQUIRE(allocations_counter.load() - before == 1);
+}
+
+TEST_CASE("null_sink", "[allocations]") {
+    spdlog::logger logger("null", std::make_shared<spdlog::sinks::null_sink_mt>());
+    REQUIRE(count_allocations(logger) == 0);
+}
+
+TEST_CASE("basic_file_sink", "[allocations]") {
+    prepare_logdir();
+    spdlog::filename_t filename = SPDLOG_FILENAME_T(TEST_FILENAME);
+    spdlog::logger logger("file", std::make_shared<spdlog::sinks::basic_file_sink_mt>(filename));
+    REQUIRE(count_allocations(logger) == 0);
+}
+
+TEST_CASE("basic_file_sink with full pattern", "[allocations]") {
+    prepare_logdir();
+    spdlog::filename_t filename = SPDLOG_FILENAME_T(TEST_FILENAME);
+    spdlog::logger logger("file", std::make_shared<spdlog::sinks::basic_file_sink_mt>(filename));
+    logger.set_pattern("[%Y-%m-%d %H:%M:%S.%F %z] [%n] [%^%l%$] [%t] [%P] [%s:%#] [%!] %v %V");
+    REQUIRE(count_allocations(logger) == 0);
+}
+
+TEST_CASE("rotating_file_sink", "[allocations]") {
+    // between rotations
+    prepare_logdir();
+    spdlog::filename_t filename = SPDLOG_FILENAME_T(TEST_FILENAME);
+    spdlog::logger logger("rotating", std::make_shared<spdlog::sinks::rotating_file_sink_mt>(filename, 1024 * 1024 * 10, 2));
+    REQUIRE(count_allocations(logger) == 0);
+}
+
+TEST_CASE("mdc", "[allocations]") {
+    prepare_logdir();
+    spdlog::filename_t filename = SPDLOG_FILENAME_T(TEST_FILENAME);
+    spdlog::logger logger("file", std::make_shared<spdlog::sinks::basic_file_sink_mt>(filename));
+    logger.set_pattern("[%l] %v %&");
+    spdlog::mdc_guard guard("request_id", "1234");
+    REQUIRE(count_allocations(logger) == 0);
+}
+
+TEST_CASE("ringbuffer_sink", "[allocations]") {
+    spdlog::logger logger("ring", std::make_shared<spdlog::sinks::ringbuffer_sink_mt>(128, 64 * 1024));
+    REQUIRE(count_allocations(logger) == 0);
+}
+
+TEST_CASE("async_logger", "[allocations]") {
+    prepare_logdir();
+    spdlog::filename_t filename = SPDLOG_FILENAME_T(TEST_FILENAME);
+    auto file_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(filename);
+    auto tp = std::make_shared<spdlog::details::thread_pool>(8192, 1);
+    auto logger = std::make_shared<spdlog::async_logger>("async", file_sink, tp, spdlog::async_overflow_policy::block);
+    auto wait_idle = [&tp] {
+        while (tp->queue_size() > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    };
+    REQUIRE(count_allocations(*logger, wait_idle) == 0);
+}
+
+#ifndef SPDLOG_MEMORY_RESOURCE
+TEST_CASE("large messages", "[allocations]") {
+    // larger than memory_buf_t's inline storage (250 bytes): formatted in the thread's reused buffer
+    prepare_logdir();
+    spdlog::filename_t filename = SPDLOG_FILENAME_T(TEST_FILENAME);
+    spdlog::logger logger("file", std::make_shared<spdlog::sinks::basic_file_sink_mt>(filename));
+    const std::string large(400, 'x');
+    logger.info("{}", large);
+
+    auto before = allocations_counter.load();
+    for (size_t i = 0; i < measured_messages; i++) {
+        logger.info("{}", large);
+    }
+    REQUIRE(allocations_counter.load() - before == 0);
+}
+
+#else
+// memory resource that counts its allocations
+class counting_resource final : public std::pmr::memory_resource {
+public:
+    std::atomic<size_t> allocations{0};
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        allocations++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+};
+
+TEST_CASE("memory resource", "[allocations]") {
+    counting_resource resource;
+    spdlog::set_memory_resource(&resource);
+    REQUIRE(spdlog::get_memory_resource() == &resource);
+    {
+        auto tp = std::make_shared<spdlog::details::thread_pool>(128, 1);
+        auto test_sink = std::make_shared<spdlog::sinks::ringbuffer_sink_mt>(1);
+        auto logger = std::make_shared<spdlog::async_logger>("async", test_sink, tp, spdlog::async_overflow_policy::block);
+        logger->info("{}", std::string(400, 'x'));
+    }
+    spdlog::set_memory_resource(nullptr);
+    REQUIRE(spdlog::get_memory_resource() == std::pmr::new_delete_resource());
+    // the logger's format buffer and the async message payload
+    REQUIRE(resource.allocations == 2);
+}
+
+TEST_CASE("large messages with pool resource", "[allocations]") {
+    std::pmr::unsynchronized_pool_resource pool;
+    spdlog::set_memory_resource(&pool);
+    {
+        prepare_logdir();
+        spdlog::filename_t filename = SPDLOG_FILENAME_T(TEST_FILENAME);
+        spdlog::logger logger("file", std::make_shared<spdlog::sinks::basic_file_sink_mt>(filename));
+        const std::string large(400, 'x');
+        logger.info("{}", large);
+
+        auto before = allocations_counter.load();
+        for (size_t i = 0; i < measured_messages; i++) {
+            logger.info("{}", large);
+        }
+        REQUIRE(allocations_counter.load() - before == 0);
+    }
+    spdlog::set_memory_resource(nullptr);
+}
+#endif
@@ -178,3 +178,34 @@ TEST_CASE("bad_tp", "[async]") {
     logger->info("Please throw an exception");
     REQUIRE(test_sink->msg_counter() == 0);
 }
+
+TEST_CASE("key/value fields", "[async]") {
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    test_sink->set_pattern("%v %V");
+    {
+        auto tp = std::make_shared<spdlog::details::thread_pool>(16, 1);
+        auto logger = std::make_shared<spdlog::async_logger>("as", test_sink, tp);
+        for (int i = 0; i < 3; i++) {
+            // the string value is destroyed before the backend thread logs it
+            std::string name = "name#" + std::to_string(i);
+            logger->info("fields", spdlog::kv("i", i), spdlog::kv("name", name));
+        }
+    }
+    REQUIRE(test_sink->lines() == std::vector<std::string>{"fields i=0 name=name#0", "fields i=1 name=name#1", "fields i=2 name=name#2"});
+}
+
+TEST_CASE("mdc", "[async]") {
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_mt>();
+    test_sink->set_pattern("%v [%&]");
+    {
+        auto tp = std::make_shared<spdlog::details::thread_pool>(16, 1);
+        auto logger = std::make_shared<spdlog::async_logger>("as", test_sink, tp);
+        for (int i = 0; i < 3; i++) {
+            // the context is gone before the backend thread logs the message
+            spdlog::mdc_guard guard("request", std::to_string(i));
+            logger->info("msg");
+        }
+        logger->info("no context");
+    }
+    REQUIRE(test_sink->lines() == std::vector<std::string>{"msg [request=0]", "msg [request=1]", "msg [request=2]", "no context []"});
+}
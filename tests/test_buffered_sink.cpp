@@ -0,0 +1,104 @@
+#include "includes.h"
+#include "spdlog/sinks/buffered_sink.h"
+#include "test_sink.h"
+
+using spdlog::sinks::buffered_sink_config;
+using spdlog::sinks::buffered_sink_mt;
+using spdlog::sinks::buffered_sink_st;
+using spdlog::sinks::test_sink_mt;
+
+static const std::string eol = spdlog::details::os::default_eol;
+
+TEST_CASE("buffered_sink max_bytes", "[buffered_sink]") {
+    auto inner = std::make_shared<test_sink_mt>();
+    buffered_sink_config config;
+    config.max_bytes = 10 * (6 + eol.size());
+    config.flush_interval = std::chrono::milliseconds::zero();
+    auto sink = std::make_shared<buffered_sink_st>(inner, config);
+    spdlog::logger logger("buffered", sink);
+    logger.set_pattern("%v");
+
+    for (int i = 0; i < 9; i++) {
+        logger.info("line {}", i);
+    }
+    REQUIRE(inner->msg_counter() == 0);
+    REQUIRE(sink->buffered_bytes() == 9 * (6 + eol.size()));
+
+    // the 10th message fills the buffer: one write with all of them
+    logger.info("line 9");
+    REQUIRE(inner->msg_counter() == 1);
+    REQUIRE(inner->flush_counter() == 0);
+    REQUIRE(sink->buffered_bytes() == 0);
+    std::string expected;
+    for (int i = 0; i < 10; i++) {
+        expected += "line " + std::to_string(i) + (i < 9 ? eol : "");
+    }
+    REQUIRE(inner->lines()[0] == expected);
+
+    logger.info("line 10");
+    logger.flush();
+    REQUIRE(inner->msg_counter() == 2);
+    REQUIRE(inner->flush_counter() == 1);
+    REQUIRE(inner->lines()[1] == "line 10");
+}
+
+TEST_CASE("buffered_sink flush_level", "[buffered_sink]") {
+    auto inner = std::make_shared<test_sink_mt>();
+    buffered_sink_config config;
+    config.flush_level = spdlog::level::warn;
+    auto sink = std::make_shared<buffered_sink_st>(inner, config);
+    spdlog::logger logger("buffered", sink);
+    logger.set_pattern("%v");
+
+    logger.info("info");
+    logger.info("info 2");
+    REQUIRE(inner->msg_counter() == 0);
+    logger.warn("warn");
+    REQUIRE(inner->msg_counter() == 1);
+    REQUIRE(inner->flush_counter() == 1);
+    REQUIRE(inner->lines()[0] == "info" + eol + "info 2" + eol + "warn");
+}
+
+TEST_CASE("buffered_sink flush_interval", "[buffered_sink]") {
+    auto inner = std::make_shared<test_sink_mt>();
+    buffered_sink_config config;
+    config.flush_interval = std::chrono::milliseconds(20);
+
+    // _st: checked when a message is logged
+    {
+        auto sink = std::make_shared<buffered_sink_st>(inner, config);
+        spdlog::logger logger("buffered", sink);
+        logger.info("first");
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        REQUIRE(inner->msg_counter() == 0);
+        logger.info("second");
+        REQUIRE(inner->msg_counter() == 1);
+    }
+
+    // _mt: written and flushed by the timer thread too
+    auto sink = std::make_shared<buffered_sink_mt>(inner, config);
+    spdlog::logger logger("buffered", sink);
+    logger.info("third");
+    REQUIRE(inner->flush_counter() == 1);  // by the destructor of the _st sink
+    for (int i = 0; i < 200 && inner->flush_counter() < 2; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    REQUIRE(inner->msg_counter() == 2);
+    REQUIRE(inner->flush_counter() == 2);
+    REQUIRE(sink->buffered_bytes() == 0);
+}
+
+TEST_CASE("buffered_sink destructor", "[buffered_sink]") {
+    auto inner = std::make_shared<test_sink_mt>();
+    {
+        spdlog::logger logger("buffered", std::make_shared<buffered_sink_mt>(inner));
+        logger.set_pattern("%v");
+        logger.info("hello");
+        REQUIRE(inner->msg_counter() == 0);
+    }
+    REQUIRE(inner->msg_counter() == 1);
+    REQUIRE(inner->flush_counter() == 1);
+    REQUIRE(inner->lines()[0] == "hello");
+
+    REQUIRE_THROWS_AS(buffered_sink_st(nullptr), spdlog::spdlog_ex);
+}
@@ -0,0 +1,75 @@
+#include "includes.h"
+#include "test_sink.h"
+
+// a call site in its own function, to be matched by name
+static void log_debug_site(spdlog::logger &logger, int i) { SPDLOG_LOGGER_DEBUG(&logger, "debug {}", i); }
+
+static void log_info_site(spdlog::logger &logger, int i) { SPDLOG_LOGGER_INFO(&logger, "info {}", i); }
+
+static void log_counted_site(spdlog::logger &logger, int &evaluated) { SPDLOG_LOGGER_INFO(&logger, "counted {}", ++evaluated); }
+
+static const spdlog::call_site_info *find_site(const std::vector<spdlog::call_site_info> &sites, const char *funcname) {
+    for (const auto &site : sites) {
+        if (std::string(site.location.funcname) == funcname) {
+            return &site;
+        }
+    }
+    return nullptr;
+}
+
+TEST_CASE("call_site enable and disable", "[call_site]") {
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    spdlog::logger logger("call_site", test_sink);
+    logger.set_pattern("%v");
+
+    // the rule applies to the site although it wasn't hit yet
+    spdlog::enable_call_sites("test_call_site.cpp", "log_debug_*");
+    log_debug_site(logger, 1);
+    log_info_site(logger, 2);
+    REQUIRE(test_sink->lines() == std::vector<std::string>{"debug 1", "info 2"});
+
+    // disabled: not logged, and the arguments are not evaluated
+    spdlog::disable_call_sites("*call_site.cpp", "log_info_site");
+    spdlog::disable_call_sites("*call_site.cpp", "log_counted_site");
+    int evaluated = 0;
+    log_info_site(logger, 3);
+    log_counted_site(logger, evaluated);
+    REQUIRE(test_sink->msg_counter() == 2);
+    REQUIRE(evaluated == 0);
+    SPDLOG_LOGGER_INFO(&logger, "other site");
+    REQUIRE(test_sink->msg_counter() == 3);
+
+    // back to the logger's level
+    spdlog::reset_call_sites();
+    log_debug_site(logger, 4);
+    log_info_site(logger, 5);
+    log_counted_site(logger, evaluated);
+    REQUIRE(evaluated == 1);
+    REQUIRE(test_sink->msg_counter() == 5);
+    REQUIRE(test_sink->lines().back() == "counted 1");
+}
+
+TEST_CASE("call_site hits", "[call_site]") {
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    spdlog::logger logger("call_site", test_sink);
+    spdlog::reset_call_site_hits();
+
+    for (int i = 0; i < 10; i++) {
+        log_info_site(logger, i);
+        log_debug_site(logger, i);  // not logged: not counted
+    }
+    log_info_site(logger, 10);
+
+    const auto sites = spdlog::call_sites();
+    const auto *info_site = find_site(sites, "log_info_site");
+    const auto *debug_site = find_site(sites, "log_debug_site");
+    REQUIRE(info_site != nullptr);
+    REQUIRE(debug_site != nullptr);
+    REQUIRE(info_site->hits == 11);
+    REQUIRE(info_site->log_level == spdlog::level::info);
+    REQUIRE(info_site->state == spdlog::call_site_state::normal);
+    REQUIRE(std::string(info_site->location.short_filename) == "test_call_site.cpp");
+    REQUIRE(debug_site->hits == 0);
+    // most hits first
+    REQUIRE(sites.front().hits >= info_site->hits);
+}
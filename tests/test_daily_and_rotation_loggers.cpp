@@ -6,6 +6,7 @@
 #include "spdlog/sinks/daily_file_sink.h"
 #include "spdlog/sinks/hourly_file_sink.h"
 #include "spdlog/sinks/rotating_file_sink.h"
+#include "spdlog/sinks/time_file_sink.h"
 
 using filename_memory_buf_t = spdlog::memory_buf_t;
 
@@ -160,4 +161,160 @@ TEST_CASE("daily_logger rotate", "[daily_file_sink]") {
     test_rotate(days_to_run, 10, 10);
     test_rotate(days_to_run, 11, 10);
     test_rotate(days_to_run, 20, 10);
-}
\ No newline at end of file
+}
+TEST_CASE("daily_logger background rotation", "[daily_file_sink]") {
+    using spdlog::sinks::daily_file_sink_st;
+    prepare_logdir();
+    spdlog::filename_t basename = SPDLOG_FILENAME_T("test_logs/daily_rotate.txt");
+    daily_file_sink_st sink{basename, 2, 30, true, 3};
+    sink.set_background_rotation(true);
+    std::vector<spdlog::filename_t> filenames;
+    for (int i = 0; i < 10; i++) {
+        auto msg = create_msg(std::chrono::seconds{24 * 3600 * i});
+        sink.log(msg);
+        filenames.push_back(sink.filename());
+    }
+    sink.wait_background_rotation();
+    REQUIRE(sink.get_rotation_stats().rotations == 9);
+    for (size_t i = 7; i < 10; i++) {
+        REQUIRE(spdlog::details::os::path_exists(filenames[i]));
+    }
+    REQUIRE_FALSE(spdlog::details::os::path_exists(filenames[5]));
+}
+
+TEST_CASE("time_rotation calendar", "[time_file_sink]") {
+    using spdlog::details::time_rotation;
+    REQUIRE(time_rotation::days_from_civil(1970, 1, 1) == 0);
+    REQUIRE(time_rotation::days_from_civil(2000, 3, 1) == 11017);
+    REQUIRE(time_rotation::days_from_civil(1969, 12, 31) == -1);
+    for (std::int64_t days = -800000; days < 800000; days += 97) {
+        std::int64_t year;
+        unsigned month, day;
+        time_rotation::civil_from_days(days, year, month, day);
+        REQUIRE(time_rotation::days_from_civil(year, month, day) == days);
+    }
+}
+
+TEST_CASE("time_rotation periods", "[time_file_sink]") {
+    using spdlog::details::time_rotation;
+    using std::chrono::minutes;
+    const auto now = spdlog::log_clock::now();
+    for (auto interval : {minutes(5), minutes(15), minutes(60), minutes(7), minutes(24 * 60)}) {
+        time_rotation rotation{interval, interval == minutes(24 * 60) ? minutes(150) : minutes(0)};
+        for (int i = 0; i < 200; i++) {
+            const auto tp = now + std::chrono::seconds(i * 1237);
+            const auto period = rotation.period_of(tp);
+            REQUIRE(period.start <= tp);
+            REQUIRE(period.end > tp);
+            REQUIRE(period.end - period.start <= interval + std::chrono::hours(1));  // +1h if DST ends in it
+
+            // same local time as the c library's
+            const std::tm expected = spdlog::details::os::localtime(spdlog::log_clock::to_time_t(period.start));
+            REQUIRE(period.start_tm.tm_year == expected.tm_year);
+            REQUIRE(period.start_tm.tm_mon == expected.tm_mon);
+            REQUIRE(period.start_tm.tm_mday == expected.tm_mday);
+            REQUIRE(period.start_tm.tm_hour == expected.tm_hour);
+            REQUIRE(period.start_tm.tm_min == expected.tm_min);
+            REQUIRE(period.start_tm.tm_wday == expected.tm_wday);
+            REQUIRE(period.start_tm.tm_yday == expected.tm_yday);
+            const auto minute_of_day =
+                (period.start_tm.tm_hour * 60 + period.start_tm.tm_min - rotation.offset().count() + 24 * 60) % (24 * 60);
+            REQUIRE(minute_of_day % interval.count() == 0);
+        }
+    }
+    REQUIRE_THROWS_AS(time_rotation{minutes(0)}, spdlog::spdlog_ex);
+    REQUIRE_THROWS_AS(time_rotation{minutes(25 * 60)}, spdlog::spdlog_ex);
+    REQUIRE_THROWS_AS((time_rotation{minutes(60), minutes(24 * 60)}), spdlog::spdlog_ex);
+}
+
+TEST_CASE("time_file_sink rotate", "[time_file_sink]") {
+    using spdlog::sinks::time_file_sink_st;
+    prepare_logdir();
+    spdlog::filename_t basename = SPDLOG_FILENAME_T("test_logs/time_rotate.txt");
+    time_file_sink_st sink{basename, std::chrono::minutes(15), true, 4};
+    std::vector<spdlog::filename_t> filenames;
+    for (int i = 0; i < 10; i++) {
+        sink.log(create_msg(std::chrono::seconds{15 * 60 * i}));
+        filenames.push_back(sink.filename());
+    }
+    REQUIRE(sink.get_rotation_stats().rotations == 9);
+    REQUIRE(count_files("test_logs") == 4);
+    for (size_t i = 6; i < 10; i++) {
+        REQUIRE(spdlog::details::os::path_exists(filenames[i]));
+        // time_rotate_YYYY-MM-DD_HH-MM.txt, on a quarter of an hour
+        const auto name = spdlog::details::os::filename_to_str(filenames[i]);
+        const auto minute = std::stoi(name.substr(name.size() - 6, 2));
+        REQUIRE(minute % 15 == 0);
+    }
+}
+
+// files of a previous execution: a daily file for each of the given days of 2001-01, the later the newer
+static std::vector<spdlog::filename_t> create_old_daily_files(const spdlog::filename_t &basename, int days, size_t size) {
+    std::vector<spdlog::filename_t> filenames;
+    std::filesystem::create_directories(spdlog::details::os::dir_name(basename));
+    const auto now = std::filesystem::file_time_type::clock::now();
+    for (int day = 1; day <= days; day++) {
+        std::tm tm{};
+        tm.tm_year = 101;
+        tm.tm_mday = day;
+        auto filename = spdlog::sinks::daily_filename_calculator::calc_filename(basename, tm);
+        std::ofstream(filename) << std::string(size, 'x');
+        std::filesystem::last_write_time(filename, now - std::chrono::hours(24 * (days - day + 1)));
+        filenames.push_back(filename);
+    }
+    return filenames;
+}
+
+TEST_CASE("daily_logger retention across restarts", "[daily_file_sink]") {
+    using spdlog::details::os::path_exists;
+    prepare_logdir();
+    spdlog::filename_t basename = SPDLOG_FILENAME_T("test_logs/daily_retention.txt");
+    auto old_files = create_old_daily_files(basename, 5, 10);
+    // compressed old file, and files of other series
+    std::filesystem::rename(old_files[3], spdlog::filename_t(old_files[3]) += SPDLOG_FILENAME_T(".gz"));
+    std::ofstream(SPDLOG_FILENAME_T("test_logs/daily_retention_other.txt")) << "x";
+    std::ofstream(SPDLOG_FILENAME_T("test_logs/daily_retention_2001-01-01.log")) << "x";
+
+    spdlog::sinks::daily_file_sink_st sink{basename, 0, 0, true, 3};
+    REQUIRE(count_files("test_logs") == 5);
+    REQUIRE(path_exists(spdlog::filename_t(old_files[3]) += SPDLOG_FILENAME_T(".gz")));
+    REQUIRE(path_exists(old_files[4]));
+    REQUIRE(path_exists(SPDLOG_FILENAME_T("test_logs/daily_retention_other.txt")));
+    REQUIRE(path_exists(SPDLOG_FILENAME_T("test_logs/daily_retention_2001-01-01.log")));
+
+    sink.log(create_msg(std::chrono::seconds{24 * 3600}));
+    REQUIRE(count_files("test_logs") == 5);
+    REQUIRE_FALSE(path_exists(spdlog::filename_t(old_files[3]) += SPDLOG_FILENAME_T(".gz")));
+}
+
+TEST_CASE("daily_logger retention of names of different lengths", "[daily_file_sink]") {
+    using spdlog::details::os::path_exists;
+    prepare_logdir();
+    // month names can't be matched strictly: files of previous runs are kept rather than risking unrelated ones
+    std::filesystem::create_directories(SPDLOG_FILENAME_T("test_logs"));
+    std::ofstream(SPDLOG_FILENAME_T("test_logs/app_backup.log")) << "x";
+    std::ofstream(SPDLOG_FILENAME_T("test_logs/app_March.log")) << "x";
+    spdlog::sinks::daily_file_format_sink_st sink{SPDLOG_FILENAME_T("test_logs/app_%B.log"), 0, 0, false, 1};
+    sink.set_max_size(1);
+    REQUIRE(path_exists(SPDLOG_FILENAME_T("test_logs/app_backup.log")));
+    REQUIRE(path_exists(SPDLOG_FILENAME_T("test_logs/app_March.log")));
+    REQUIRE(path_exists(sink.filename()));
+}
+
+TEST_CASE("daily_logger max size", "[daily_file_sink]") {
+    using spdlog::details::os::path_exists;
+    prepare_logdir();
+    spdlog::filename_t basename = SPDLOG_FILENAME_T("test_logs/daily_max_size.txt");
+    auto old_files = create_old_daily_files(basename, 5, 100);
+
+    spdlog::sinks::daily_file_sink_st sink{basename, 0, 0, true};
+    sink.set_max_size(250);
+    REQUIRE(count_files("test_logs") == 3);
+    REQUIRE(path_exists(old_files[3]));
+    REQUIRE(path_exists(old_files[4]));
+
+    // the current file is never deleted
+    sink.set_max_size(1);
+    REQUIRE(count_files("test_logs") == 1);
+    REQUIRE(path_exists(sink.filename()));
+}
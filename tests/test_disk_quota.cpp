@@ -0,0 +1,115 @@
+#include "includes.h"
+#include "spdlog/disk_quota.h"
+#include "spdlog/sinks/daily_file_sink.h"
+#include "spdlog/sinks/rotating_file_sink.h"
+
+using spdlog::sinks::rotating_file_sink_st;
+using spdlog::sinks::rotation_naming;
+
+// "message\n" - 8 bytes per message
+static void set_message_pattern(spdlog::sinks::sink &sink) {
+    sink.set_formatter(std::make_unique<spdlog::pattern_formatter>("%v", spdlog::pattern_time_type::local, "\n"));
+}
+
+// size of the regular files (not the links to the current files) in the folder
+static size_t regular_files_size(const spdlog::filename_t &folder) {
+    size_t size = 0;
+    for (const auto &entry : std::filesystem::directory_iterator(folder)) {
+        if (std::filesystem::is_regular_file(entry.symlink_status())) {
+            size += static_cast<size_t>(entry.file_size());
+        }
+    }
+    return size;
+}
+
+TEST_CASE("disk_quota evicts the oldest files of all sinks", "[disk_quota]") {
+    prepare_logdir();
+    auto quota = std::make_shared<spdlog::disk_quota>(500);
+    rotating_file_sink_st sink1{SPDLOG_FILENAME_T("test_logs/quota1.txt"), 100, 10, false, {}, rotation_naming::monotonic};
+    rotating_file_sink_st sink2{SPDLOG_FILENAME_T("test_logs/quota2.txt"), 100, 10, false, {}, rotation_naming::monotonic};
+    set_message_pattern(sink1);
+    set_message_pattern(sink2);
+    sink1.set_disk_quota(quota);
+    sink2.set_disk_quota(quota);
+
+    for (int i = 0; i < 100; i++) {
+        sink1.log(spdlog::details::log_msg{"test", spdlog::level::info, "message"});
+        sink2.log(spdlog::details::log_msg{"test", spdlog::level::info, "message"});
+    }
+    sink1.flush();
+    sink2.flush();
+
+    const auto stats = quota->stats();
+    REQUIRE(stats.sinks == 2);
+    REQUIRE(stats.bytes_written == 200 * 8);
+    REQUIRE(stats.bytes_on_disk <= 500);
+    REQUIRE(stats.bytes_on_disk + stats.evicted_bytes == stats.bytes_written);
+    REQUIRE(stats.evicted_files > 0);
+    REQUIRE(regular_files_size(SPDLOG_FILENAME_T("test_logs")) == stats.bytes_on_disk);
+    // both sinks keep their newest files
+    REQUIRE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T("test_logs/quota1.8.txt")));
+    REQUIRE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T("test_logs/quota2.8.txt")));
+    REQUIRE_FALSE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T("test_logs/quota1.1.txt")));
+    REQUIRE_FALSE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T("test_logs/quota2.1.txt")));
+
+    // unregister
+    sink2.set_disk_quota(nullptr);
+    REQUIRE(quota->stats().sinks == 1);
+    REQUIRE(quota->stats().bytes_on_disk <= 250);
+}
+
+TEST_CASE("disk_quota counts the existing files", "[disk_quota]") {
+    prepare_logdir();
+    spdlog::filename_t basename = SPDLOG_FILENAME_T("test_logs/quota_daily.txt");
+    std::filesystem::create_directories(SPDLOG_FILENAME_T("test_logs"));
+    const auto now = std::filesystem::file_time_type::clock::now();
+    std::vector<spdlog::filename_t> old_files;
+    for (int day = 1; day <= 5; day++) {
+        std::tm tm{};
+        tm.tm_year = 101;
+        tm.tm_mday = day;
+        old_files.push_back(spdlog::sinks::daily_filename_calculator::calc_filename(basename, tm));
+        std::ofstream(old_files.back()) << std::string(100, 'x');
+        std::filesystem::last_write_time(old_files.back(), now - std::chrono::hours(24 * (6 - day)));
+    }
+
+    spdlog::sinks::daily_file_sink_st sink{basename, 0, 0, true};
+    sink.set_disk_quota(std::make_shared<spdlog::disk_quota>(250));
+    REQUIRE(count_files("test_logs") == 3);
+    REQUIRE(spdlog::details::os::path_exists(old_files[3]));
+    REQUIRE(spdlog::details::os::path_exists(old_files[4]));
+}
+
+TEST_CASE("disk_quota sampling", "[disk_quota]") {
+    prepare_logdir();
+    auto quota = std::make_shared<spdlog::disk_quota>(1000);
+    quota->set_sampling(0.5, 10);
+    rotating_file_sink_st normal{SPDLOG_FILENAME_T("test_logs/normal.txt"), 10000, 1, false, {}, rotation_naming::monotonic};
+    rotating_file_sink_st low{SPDLOG_FILENAME_T("test_logs/low.txt"), 10000, 1, false, {}, rotation_naming::monotonic};
+    set_message_pattern(normal);
+    set_message_pattern(low);
+    normal.set_disk_quota(quota);
+    low.set_disk_quota(quota, spdlog::quota_priority::low);
+
+    for (int i = 0; i < 50; i++) {
+        low.log(spdlog::details::log_msg{"test", spdlog::level::info, "message"});
+    }
+    REQUIRE_FALSE(quota->stats().sampling);
+    REQUIRE(quota->stats().sampled_out == 0);
+    for (int i = 0; i < 100; i++) {
+        normal.log(spdlog::details::log_msg{"test", spdlog::level::info, "message"});
+    }
+    REQUIRE(quota->stats().sampling);
+    for (int i = 0; i < 100; i++) {
+        low.log(spdlog::details::log_msg{"test", spdlog::level::info, "message"});
+    }
+    const auto stats = quota->stats();
+    REQUIRE(stats.sampled_out == 90);
+    REQUIRE(stats.bytes_written == 160 * 8);
+}
+
+TEST_CASE("disk_quota requires monotonic naming", "[disk_quota]") {
+    prepare_logdir();
+    rotating_file_sink_st sink{SPDLOG_FILENAME_T("test_logs/shift.txt"), 100, 3};
+    REQUIRE_THROWS_AS(sink.set_disk_quota(std::make_shared<spdlog::disk_quota>(500)), spdlog::spdlog_ex);
+}
@@ -0,0 +1,86 @@
+#include "includes.h"
+#include "spdlog/sinks/fanout_sink.h"
+#include "test_sink.h"
+
+using spdlog::sinks::fanout_sink_mt;
+using spdlog::sinks::test_sink_mt;
+
+TEST_CASE("fanout_sink", "[fanout_sink]") {
+    auto sink1 = std::make_shared<test_sink_mt>();
+    auto sink2 = std::make_shared<test_sink_mt>();
+    auto fanout = std::make_shared<fanout_sink_mt>(std::vector<spdlog::sink_ptr>{sink1, sink2});
+    spdlog::logger logger("fanout", fanout);
+    logger.set_pattern("%v");
+    for (int i = 0; i < 100; i++) {
+        logger.info("message {}", i);
+    }
+    logger.flush();
+    fanout->wait_idle();
+
+    for (auto &child : {sink1, sink2}) {
+        REQUIRE(child->msg_counter() == 100);
+        REQUIRE(child->flush_counter() == 1);
+        REQUIRE(child->lines()[0] == "message 0");
+        REQUIRE(child->lines()[99] == "message 99");
+    }
+    const auto stats = fanout->stats();
+    REQUIRE(stats.size() == 2);
+    for (const auto &s : stats) {
+        REQUIRE(s.pending == 0);
+        REQUIRE(s.written == 100);
+        REQUIRE(s.dropped == 0);
+        REQUIRE(s.failed == 0);
+    }
+}
+
+TEST_CASE("fanout_sink child level", "[fanout_sink]") {
+    auto sink1 = std::make_shared<test_sink_mt>();
+    auto sink2 = std::make_shared<test_sink_mt>();
+    sink2->set_level(spdlog::level::warn);
+    auto fanout = std::make_shared<fanout_sink_mt>(std::vector<spdlog::sink_ptr>{sink1, sink2});
+    spdlog::logger logger("fanout", fanout);
+    logger.info("info");
+    logger.warn("warn");
+    fanout->wait_idle();
+    REQUIRE(sink1->msg_counter() == 2);
+    REQUIRE(sink2->msg_counter() == 1);
+}
+
+TEST_CASE("fanout_sink slow child", "[fanout_sink]") {
+    auto fast = std::make_shared<test_sink_mt>();
+    auto slow = std::make_shared<test_sink_mt>();
+    slow->set_delay(std::chrono::milliseconds(50));
+    auto fanout = std::make_shared<fanout_sink_mt>(std::vector<spdlog::sink_ptr>{fast, slow}, 8);
+    spdlog::logger logger("fanout", fanout);
+    for (int i = 0; i < 50; i++) {
+        logger.info("message {}", i);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    fanout->wait_idle();
+
+    // the slow child lost what didn't fit its queue, the fast one got everything
+    const auto stats = fanout->stats();
+    REQUIRE(stats[0].written == 50);
+    REQUIRE(stats[0].dropped == 0);
+    REQUIRE(stats[1].dropped > 0);
+    REQUIRE(stats[1].written + stats[1].dropped == 50);
+    REQUIRE(fast->msg_counter() == 50);
+    REQUIRE(slow->msg_counter() == stats[1].written);
+}
+
+TEST_CASE("fanout_sink block", "[fanout_sink]") {
+    auto slow = std::make_shared<test_sink_mt>();
+    slow->set_delay(std::chrono::milliseconds(1));
+    {
+        auto fanout =
+            std::make_shared<fanout_sink_mt>(std::vector<spdlog::sink_ptr>{slow}, 2, spdlog::async_overflow_policy::block);
+        spdlog::logger logger("fanout", fanout);
+        for (int i = 0; i < 20; i++) {
+            logger.info("message {}", i);
+        }
+    }
+    // the destructor writes what's queued
+    REQUIRE(slow->msg_counter() == 20);
+
+    REQUIRE_THROWS_AS(fanout_sink_mt({slow}, 2, spdlog::async_overflow_policy::overrun_oldest), spdlog::spdlog_ex);
+}
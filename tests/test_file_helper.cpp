@@ -3,6 +3,7 @@
  * https://raw.githubusercontent.com/gabime/spdlog/v2.x/LICENSE
  */
 #include "includes.h"
+#include "spdlog/sinks/basic_file_sink.h"
 #include "spdlog/sinks/rotating_file_sink.h"
 
 #define TEST_FILENAME "test_logs/file_helper_test.txt"
@@ -61,6 +62,25 @@ TEST_CASE("file_helper_reopen2", "[file_helper::reopen(false)]") {
     REQUIRE(helper.size() == expected_size);
 }
 
+TEST_CASE("file_helper_resync", "[file_helper::resync()]") {
+    prepare_logdir();
+    spdlog::filename_t target_filename = SPDLOG_FILENAME_T(TEST_FILENAME);
+    file_helper helper;
+    helper.open(target_filename);
+    spdlog::memory_buf_t buf;
+    buf.append(std::string("0123456789"));
+    helper.write(buf);
+    // tracked without flushing
+    REQUIRE(helper.size() == 10);
+    helper.flush();
+
+    // truncated by someone else
+    std::filesystem::resize_file(TEST_FILENAME, 4);
+    REQUIRE(helper.size() == 10);
+    REQUIRE(helper.resync() == 4);
+    REQUIRE(helper.size() == 4);
+}
+
 static void test_split_ext(const spdlog::filename_t::value_type *fname,
                            const spdlog::filename_t::value_type *expect_base,
                            const spdlog::filename_t::value_type *expect_ext) {
@@ -156,3 +176,250 @@ TEST_CASE("file_helper_open", "[file_helper]") {
     target_filename += SPDLOG_FILENAME_T("/invalid");
     REQUIRE_THROWS_AS(helper.open(target_filename), spdlog::spdlog_ex);
 }
+
+TEST_CASE("file_helper_write_buffer", "[file_helper]") {
+    prepare_logdir();
+    spdlog::filename_t target_filename = SPDLOG_FILENAME_T(TEST_FILENAME);
+    spdlog::file_event_handlers handlers;
+    handlers.after_open = [](spdlog::filename_t, std::FILE *fstream) { fputs("header\n", fstream); };
+    handlers.before_close = [](spdlog::filename_t, std::FILE *fstream) { fputs("footer\n", fstream); };
+    {
+        file_helper helper{handlers, 64};
+        REQUIRE(helper.write_buffer_size() == 64);
+        helper.open(target_filename);
+
+        spdlog::memory_buf_t buf;
+        buf.append(std::string("0123456789\n"));
+        helper.write(buf);
+        // still in the buffer but accounted for
+        REQUIRE(get_filesize(TEST_FILENAME) == 7);
+        REQUIRE(helper.size() == 7 + 11);
+        helper.flush();
+        REQUIRE(get_filesize(TEST_FILENAME) == 7 + 11);
+
+        // spans larger than the buffer are written directly
+        const std::string large(100, 'x');
+        const spdlog::string_view_t spans[] = {"a", large, "\n"};
+        helper.write(buf);
+        helper.write(spans, 3);
+        REQUIRE(get_filesize(TEST_FILENAME) == 7 + 11 + 11 + 102);
+
+        // fill the buffer until it is written
+        for (int i = 0; i < 6; i++) {
+            helper.write(buf);
+        }
+        REQUIRE(get_filesize(TEST_FILENAME) == 7 + 11 + 11 + 102 + 55);
+        REQUIRE(helper.size() == 7 + 11 + 11 + 102 + 66);
+    }
+    // the destructor writes what's left before the before_close handler
+    auto contents = file_contents(TEST_FILENAME);
+    REQUIRE(contents.size() == 7 + 11 + 11 + 102 + 66 + 7);
+    REQUIRE(contents.substr(0, 18) == "header\n0123456789\n");
+    REQUIRE(contents.substr(contents.size() - 18) == "0123456789\nfooter\n");
+}
+
+TEST_CASE("file_helper_write_spans", "[file_helper]") {
+    prepare_logdir();
+    spdlog::filename_t target_filename = SPDLOG_FILENAME_T(TEST_FILENAME);
+    file_helper helper;
+    helper.open(target_filename);
+    const spdlog::string_view_t spans[] = {"abc", "", "def\n"};
+    helper.write(spans, 3);
+    helper.flush();
+    REQUIRE(file_contents(TEST_FILENAME) == "abcdef\n");
+}
+
+TEST_CASE("file_helper_preallocate", "[file_helper]") {
+    prepare_logdir();
+    spdlog::filename_t target_filename = SPDLOG_FILENAME_T(TEST_FILENAME);
+    spdlog::file_event_handlers handlers;
+    handlers.after_open = [](spdlog::filename_t, std::FILE *fstream) { fputs("header\n", fstream); };
+    handlers.before_close = [](spdlog::filename_t, std::FILE *fstream) { fputs("footer\n", fstream); };
+    for (size_t write_buffer_size : {size_t{0}, size_t{64}}) {
+        {
+            file_helper helper{handlers, write_buffer_size};
+            helper.set_preallocate(4096);
+            helper.open(target_filename, true);
+            write_with_helper(helper, 10);
+            REQUIRE(helper.size() == 7 + 10);
+#ifdef __linux__
+            REQUIRE(get_filesize(TEST_FILENAME) == 4096);
+#endif
+        }
+        // truncated to what was written
+        REQUIRE(file_contents(TEST_FILENAME) == "header\n1111111111footer\n");
+
+        // not truncating continues after the written data
+        {
+            file_helper helper{handlers, write_buffer_size};
+            helper.set_preallocate(4096);
+            helper.open(target_filename);
+            write_with_helper(helper, 3);
+            REQUIRE(helper.size() == 24 + 7 + 3);
+        }
+        REQUIRE(file_contents(TEST_FILENAME) == "header\n1111111111footer\nheader\n111footer\n");
+
+        // truncating overwrites the file from its start
+        {
+            file_helper helper{handlers, write_buffer_size};
+            helper.set_preallocate(4096);
+            helper.open(target_filename, true);
+            write_with_helper(helper, 2);
+        }
+        REQUIRE(file_contents(TEST_FILENAME) == "header\n11footer\n");
+    }
+}
+
+// offsets past 2GB, where long is 32 bit
+TEST_CASE("file_helper_seek_large_offset", "[file_helper]") {
+    if (sizeof(size_t) < 8) {
+        return;
+    }
+    std::FILE *fp = std::tmpfile();
+    REQUIRE(fp != nullptr);
+    const size_t offset = size_t{3} * 1024 * 1024 * 1024 + 10;
+    REQUIRE(spdlog::details::os::seek(fp, offset));
+    REQUIRE(spdlog::details::os::file_offset(fp) == offset);
+    std::fclose(fp);
+}
+
+// lines of varying length, so the writes cross the block and buffer boundaries at any offset
+static std::string write_lines(const file_helper &helper, int first, int count) {
+    std::string expected;
+    for (int i = first; i < first + count; i++) {
+        spdlog::memory_buf_t formatted;
+        const std::string padding(static_cast<size_t>(i % 97), 'x');
+        spdlog::fmt_lib::format_to(std::back_inserter(formatted), "line {} {}\n", i, padding);
+        helper.write(formatted);
+        expected.append(formatted.data(), formatted.size());
+        if (i % 500 == 0) {
+            helper.flush();
+        }
+    }
+    return expected;
+}
+
+TEST_CASE("file_helper_page_cache_mode", "[file_helper]") {
+    using spdlog::page_cache_mode;
+    spdlog::filename_t target_filename = SPDLOG_FILENAME_T(TEST_FILENAME);
+    spdlog::file_event_handlers handlers;
+    handlers.after_open = [](spdlog::filename_t, std::FILE *fstream) { fputs("header\n", fstream); };
+    handlers.before_close = [](spdlog::filename_t, std::FILE *fstream) { fputs("footer\n", fstream); };
+    for (auto mode : {page_cache_mode::drop, page_cache_mode::bypass}) {
+        for (size_t write_buffer_size : {size_t{0}, size_t{8192}}) {
+            prepare_logdir();
+            std::string expected = "header\n";
+            {
+                file_helper helper{handlers, write_buffer_size};
+                helper.set_page_cache_mode(mode);
+                helper.open(target_filename, true);
+                expected += write_lines(helper, 0, 20000);
+                helper.flush();
+                REQUIRE(helper.size() == expected.size());
+                REQUIRE(file_contents(TEST_FILENAME) == expected);
+
+                // continue from an unaligned size
+                helper.reopen(false);
+                expected += "footer\nheader\n";
+                expected += write_lines(helper, 20000, 100);
+                REQUIRE(helper.size() == expected.size());
+            }
+            expected += "footer\n";
+            REQUIRE(file_contents(TEST_FILENAME) == expected);
+        }
+    }
+}
+
+TEST_CASE("basic_file_sink write buffer", "[file_helper]") {
+    prepare_logdir();
+    spdlog::filename_t target_filename = SPDLOG_FILENAME_T(TEST_FILENAME);
+    auto logger = spdlog::basic_logger_mt("buffered_logger", target_filename, false, {}, 4096);
+    logger->set_pattern("%v");
+    for (int i = 0; i < 1000; i++) {
+        logger->info("Test message {}", i);
+    }
+    logger->flush();
+    REQUIRE(count_lines(TEST_FILENAME) == 1000);
+}
+
+// the syncs run on a background thread - wait for them a bit
+static size_t wait_for_syncs(const file_helper &helper, size_t expected) {
+    for (int i = 0; i < 200 && helper.sync_counter() < expected; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return helper.sync_counter();
+}
+
+TEST_CASE("file_helper_sync_policy", "[file_helper]") {
+    prepare_logdir();
+    spdlog::filename_t target_filename = SPDLOG_FILENAME_T(TEST_FILENAME);
+    spdlog::memory_buf_t buf;
+    spdlog::fmt_lib::format_to(std::back_inserter(buf), "{}", std::string(10, '1'));
+
+    SECTION("disabled") {
+        file_helper helper;
+        helper.open(target_filename);
+        helper.set_sync_policy({});
+        helper.write(buf);
+        helper.sync_by_policy(spdlog::level::critical);
+        REQUIRE(helper.sync_counter() == 0);
+    }
+
+    SECTION("on level") {
+        file_helper helper;
+        helper.open(target_filename);
+        spdlog::file_sync_policy policy;
+        policy.on_level = spdlog::level::err;
+        helper.set_sync_policy(policy);
+        helper.write(buf);
+        helper.sync_by_policy(spdlog::level::info);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        REQUIRE(helper.sync_counter() == 0);
+        helper.sync_by_policy(spdlog::level::err);
+        REQUIRE(wait_for_syncs(helper, 1) == 1);
+        // the data was flushed to the file by the logging thread
+        REQUIRE(file_contents(TEST_FILENAME).size() == 10);
+    }
+
+    SECTION("every bytes") {
+        file_helper helper;
+        helper.open(target_filename);
+        spdlog::file_sync_policy policy;
+        policy.every_bytes = 25;
+        helper.set_sync_policy(policy);
+        for (int i = 0; i < 2; i++) {
+            helper.write(buf);
+            helper.sync_by_policy(spdlog::level::info);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        REQUIRE(helper.sync_counter() == 0);
+        helper.write(buf);
+        helper.sync_by_policy(spdlog::level::info);
+        REQUIRE(wait_for_syncs(helper, 1) == 1);
+    }
+
+    SECTION("on close") {
+        file_helper helper;
+        helper.open(target_filename);
+        spdlog::file_sync_policy policy;
+        policy.every_bytes = 1024;
+        helper.set_sync_policy(policy);
+        helper.write(buf);
+        helper.close();
+        REQUIRE(wait_for_syncs(helper, 1) == 1);
+    }
+}
+
+TEST_CASE("basic_file_sink sync policy", "[file_helper]") {
+    prepare_logdir();
+    spdlog::filename_t target_filename = SPDLOG_FILENAME_T(TEST_FILENAME);
+    auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(target_filename);
+    spdlog::file_sync_policy policy;
+    policy.every = std::chrono::milliseconds(10);
+    sink->set_sync_policy(policy);
+    spdlog::logger logger("sync_logger", sink);
+    logger.info("Test message 1");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    logger.info("Test message 2");  // the interval passed - flushed and synced
+    REQUIRE(count_lines(TEST_FILENAME) == 2);
+}
@@ -6,6 +6,16 @@
 #include "spdlog/sinks/basic_file_sink.h"
 #include "spdlog/sinks/rotating_file_sink.h"
 
+#ifndef _WIN32
+    #include "spdlog/sinks/mmap_file_sink.h"
+#endif
+#ifdef __linux__
+    #include "spdlog/sinks/uring_file_sink.h"
+#endif
+#ifdef SPDLOG_ZLIB
+    #include <zlib.h>
+#endif
+
 #define SIMPLE_LOG "test_logs/simple_log"
 #define ROTATING_LOG "test_logs/rotating_log"
 
@@ -111,3 +121,392 @@ TEST_CASE("rotating_file_logger4", "[rotating_logger]") {
     REQUIRE(get_filesize(ROTATING_LOG) > 0);
     REQUIRE(get_filesize(ROTATING_LOG ".1") > 0);
 }
+
+TEST_CASE("rotating_file_logger monotonic naming", "[rotating_logger]") {
+    prepare_logdir();
+    size_t max_size = 1024;
+    spdlog::filename_t basename = SPDLOG_FILENAME_T(ROTATING_LOG ".txt");
+    const auto naming = spdlog::sinks::rotation_naming::monotonic;
+    spdlog::file_event_handlers handlers;
+    auto sink = std::make_shared<spdlog::sinks::rotating_file_sink_st>(basename, max_size, 2, false, handlers, naming);
+    auto logger = std::make_shared<spdlog::logger>("rotating_sink_logger", sink);
+    logger->set_pattern("%v");
+    REQUIRE(sink->filename() == spdlog::filename_t(SPDLOG_FILENAME_T(ROTATING_LOG ".1.txt")));
+
+    for (int i = 0; i < 5; i++) {
+        logger->info("Test message {}", i);
+        sink->rotate_now();
+    }
+    logger->info("Test message 5");
+    logger->flush();
+
+    // the current file and the last 2 are kept
+    REQUIRE(sink->filename() == spdlog::filename_t(SPDLOG_FILENAME_T(ROTATING_LOG ".6.txt")));
+    REQUIRE_FALSE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T(ROTATING_LOG ".3.txt")));
+    REQUIRE(get_filesize(ROTATING_LOG ".4.txt") > 0);
+    REQUIRE(get_filesize(ROTATING_LOG ".5.txt") > 0);
+    #ifndef _WIN32
+    REQUIRE(file_contents(ROTATING_LOG ".txt") == file_contents(ROTATING_LOG ".6.txt"));
+    #endif
+
+    // a new sink continues with the last file and deletes what is beyond max_files
+    sink.reset();
+    logger.reset();
+    sink = std::make_shared<spdlog::sinks::rotating_file_sink_st>(basename, max_size, 1, false, handlers, naming);
+    REQUIRE(sink->filename() == spdlog::filename_t(SPDLOG_FILENAME_T(ROTATING_LOG ".6.txt")));
+    REQUIRE_FALSE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T(ROTATING_LOG ".4.txt")));
+    REQUIRE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T(ROTATING_LOG ".5.txt")));
+}
+
+TEST_CASE("rotating_file_logger background rotation", "[rotating_logger]") {
+    prepare_logdir();
+    size_t max_size = 1024;
+    spdlog::filename_t basename = SPDLOG_FILENAME_T(ROTATING_LOG);
+    auto sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(basename, max_size, 2);
+    sink->set_background_rotation(true);
+    auto logger = std::make_shared<spdlog::logger>("rotating_sink_logger", sink);
+    logger->set_pattern("%v");
+    for (int i = 0; i < 200; i++) {
+        logger->info("Test message {}", i);
+    }
+    logger->flush();
+    sink->wait_background_rotation();
+
+    auto stats = sink->get_rotation_stats();
+    REQUIRE(stats.rotations > 2);
+    REQUIRE(stats.max_stall >= stats.last_stall);
+    REQUIRE(stats.total_stall >= stats.max_stall);
+    REQUIRE(get_filesize(ROTATING_LOG) <= max_size);
+    REQUIRE(get_filesize(ROTATING_LOG ".1") > max_size / 2);
+    REQUIRE(get_filesize(ROTATING_LOG ".1") <= max_size);
+    REQUIRE(get_filesize(ROTATING_LOG ".2") > max_size / 2);
+    REQUIRE(get_filesize(ROTATING_LOG ".2") <= max_size);
+    REQUIRE_FALSE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T(ROTATING_LOG ".3")));
+}
+
+TEST_CASE("rotating_file_logger stale staging files", "[rotating_logger]") {
+    using spdlog::details::os::path_exists;
+    auto write_file = [](const char *name, const std::string &contents) {
+        std::FILE *fp = std::fopen(name, "wb");
+        REQUIRE(fp != nullptr);
+        std::fwrite(contents.data(), 1, contents.size(), fp);
+        std::fclose(fp);
+    };
+    prepare_logdir();
+    spdlog::details::os::create_dir(SPDLOG_FILENAME_T("test_logs"));
+    // left by a run that crashed during background rotations
+    write_file(ROTATING_LOG ".1", "one");
+    write_file(ROTATING_LOG ".rotated.10", "ten");
+    write_file(ROTATING_LOG ".rotated.9", "nine");
+    write_file(ROTATING_LOG ".next", "");
+    write_file(ROTATING_LOG ".rotated.x", "x");
+    spdlog::filename_t basename = SPDLOG_FILENAME_T(ROTATING_LOG);
+    {
+        spdlog::sinks::rotating_file_sink_st sink(basename, 1024, 3);
+        // shifted into the chain in sequence order
+        REQUIRE(file_contents(ROTATING_LOG ".1") == "ten");
+        REQUIRE(file_contents(ROTATING_LOG ".2") == "nine");
+        REQUIRE(file_contents(ROTATING_LOG ".3") == "one");
+        REQUIRE_FALSE(path_exists(SPDLOG_FILENAME_T(ROTATING_LOG ".rotated.9")));
+        REQUIRE_FALSE(path_exists(SPDLOG_FILENAME_T(ROTATING_LOG ".rotated.10")));
+        REQUIRE_FALSE(path_exists(SPDLOG_FILENAME_T(ROTATING_LOG ".next")));
+        REQUIRE(path_exists(SPDLOG_FILENAME_T(ROTATING_LOG ".rotated.x")));
+    }
+
+    // a next file with data is kept, and so are rotated files without a chain
+    write_file(ROTATING_LOG ".rotated.1", "rotated");
+    write_file(ROTATING_LOG ".next", "next");
+    {
+        spdlog::sinks::rotating_file_sink_st sink(basename, 1024, 0);
+        REQUIRE(file_contents(ROTATING_LOG ".rotated.1") == "rotated");
+        REQUIRE(file_contents(ROTATING_LOG ".next") == "next");
+    }
+}
+
+TEST_CASE("rotating_file_logger preallocation", "[rotating_logger]") {
+    prepare_logdir();
+    size_t max_size = 1024;
+    spdlog::filename_t basename = SPDLOG_FILENAME_T(ROTATING_LOG);
+    auto sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(basename, max_size, 2);
+    sink->set_preallocation(true);
+    auto logger = std::make_shared<spdlog::logger>("rotating_sink_logger", sink);
+    logger->set_pattern("%v");
+    for (int i = 0; i < 200; i++) {
+        logger->info("Test message {}", i);
+    }
+    logger->flush();
+    sink->wait_background_rotation();
+    REQUIRE(sink->get_rotation_stats().rotations > 2);
+#ifdef __linux__
+    // the next file is ready, preallocated
+    REQUIRE(get_filesize(ROTATING_LOG ".next") == max_size);
+#endif
+    // the rotated files were truncated to their content
+    for (const char *filename : {ROTATING_LOG ".1", ROTATING_LOG ".2"}) {
+        const auto contents = file_contents(filename);
+        REQUIRE(contents.size() > max_size / 2);
+        REQUIRE(contents.size() <= max_size);
+        REQUIRE(contents.find('\0') == std::string::npos);
+        REQUIRE(contents.compare(0, 13, "Test message ") == 0);
+        REQUIRE(contents.back() == '\n');
+    }
+    REQUIRE_FALSE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T(ROTATING_LOG ".3")));
+    logger.reset();
+    sink.reset();
+    const auto contents = file_contents(ROTATING_LOG);
+    REQUIRE(contents.find('\0') == std::string::npos);
+    REQUIRE(contents.substr(contents.size() - 17) == "Test message 199\n");
+}
+
+TEST_CASE("rotating_file_logger monotonic preallocation", "[rotating_logger]") {
+    prepare_logdir();
+    spdlog::filename_t basename = SPDLOG_FILENAME_T(ROTATING_LOG ".txt");
+    const auto naming = spdlog::sinks::rotation_naming::monotonic;
+    spdlog::file_event_handlers handlers;
+    auto sink = std::make_shared<spdlog::sinks::rotating_file_sink_st>(basename, 1024, 2, false, handlers, naming);
+    sink->set_preallocation(true);
+    auto logger = std::make_shared<spdlog::logger>("rotating_sink_logger", sink);
+    logger->set_pattern("%v");
+    for (int i = 0; i < 5; i++) {
+        logger->info("Test message {}", i);
+        sink->rotate_now();
+    }
+    sink->wait_background_rotation();
+    REQUIRE(sink->filename() == spdlog::filename_t(SPDLOG_FILENAME_T(ROTATING_LOG ".6.txt")));
+    // the oldest file became the next one
+    REQUIRE_FALSE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T(ROTATING_LOG ".3.txt")));
+    REQUIRE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T(ROTATING_LOG ".7.txt")));
+    REQUIRE(file_contents(ROTATING_LOG ".4.txt") == "Test message 3\n");
+    REQUIRE(file_contents(ROTATING_LOG ".5.txt") == "Test message 4\n");
+}
+
+TEST_CASE("rotating_file_logger monotonic background rotation", "[rotating_logger]") {
+    prepare_logdir();
+    spdlog::filename_t basename = SPDLOG_FILENAME_T(ROTATING_LOG ".txt");
+    const auto naming = spdlog::sinks::rotation_naming::monotonic;
+    spdlog::file_event_handlers handlers;
+    auto sink = std::make_shared<spdlog::sinks::rotating_file_sink_st>(basename, 1024, 2, false, handlers, naming);
+    sink->set_background_rotation(true);
+    auto logger = std::make_shared<spdlog::logger>("rotating_sink_logger", sink);
+    for (int i = 0; i < 5; i++) {
+        logger->info("Test message {}", i);
+        sink->rotate_now();
+    }
+    sink->wait_background_rotation();
+    REQUIRE(sink->get_rotation_stats().rotations == 5);
+    REQUIRE(sink->filename() == spdlog::filename_t(SPDLOG_FILENAME_T(ROTATING_LOG ".6.txt")));
+    REQUIRE_FALSE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T(ROTATING_LOG ".3.txt")));
+    REQUIRE(get_filesize(ROTATING_LOG ".4.txt") > 0);
+    REQUIRE(get_filesize(ROTATING_LOG ".5.txt") > 0);
+}
+
+#ifdef SPDLOG_ZLIB
+// decompress what can be decompressed (a live compressed file may not be finished yet)
+static std::string gunzip_contents(const char *filename) {
+    std::string contents;
+    gzFile file = gzopen(filename, "rb");
+    REQUIRE(file != nullptr);
+    char buf[4096];
+    int n;
+    while ((n = gzread(file, buf, sizeof(buf))) > 0) {
+        contents.append(buf, static_cast<size_t>(n));
+    }
+    gzclose(file);
+    return contents;
+}
+
+static size_t count_gunzip_lines(const char *filename) {
+    auto contents = gunzip_contents(filename);
+    return static_cast<size_t>(std::count(contents.begin(), contents.end(), '\n'));
+}
+
+TEST_CASE("rotating_file_logger rotated compression", "[rotating_logger]") {
+    prepare_logdir();
+    size_t max_size = 1024;
+    spdlog::filename_t basename = SPDLOG_FILENAME_T(ROTATING_LOG);
+    auto sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(basename, max_size, 2);
+    spdlog::file_compression compression;
+    compression.mode = spdlog::compression_mode::rotated;
+    sink->set_compression(compression);
+    auto logger = std::make_shared<spdlog::logger>("rotating_sink_logger", sink);
+    logger->set_pattern("%v");
+    for (int i = 0; i < 200; i++) {
+        logger->info("Test message {}", i);
+    }
+    logger->flush();
+    sink->wait_background_rotation();
+
+    REQUIRE_FALSE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T(ROTATING_LOG ".1")));
+    REQUIRE_FALSE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T(ROTATING_LOG ".3.gz")));
+    auto lines = count_lines(ROTATING_LOG);
+    lines += count_gunzip_lines(ROTATING_LOG ".1.gz") + count_gunzip_lines(ROTATING_LOG ".2.gz");
+    REQUIRE(lines > 100);
+    auto last = gunzip_contents(ROTATING_LOG ".1.gz");
+    REQUIRE(last.size() <= max_size);
+    REQUIRE(get_filesize(ROTATING_LOG ".1.gz") < last.size());
+}
+
+TEST_CASE("rotating_file_logger rotated compression and background rotation", "[rotating_logger]") {
+    spdlog::file_compression compression;
+    compression.mode = spdlog::compression_mode::rotated;
+    // enabling background rotation keeps the compression, whatever the order
+    for (bool compression_first : {true, false}) {
+        prepare_logdir();
+        spdlog::filename_t basename = SPDLOG_FILENAME_T(ROTATING_LOG);
+        auto sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(basename, 1024, 2);
+        if (compression_first) {
+            sink->set_compression(compression);
+            sink->set_background_rotation(true);
+        } else {
+            sink->set_background_rotation(true);
+            sink->set_compression(compression);
+        }
+        spdlog::logger logger("rotating_sink_logger", sink);
+        logger.info("Test message");
+        sink->rotate_now();
+        sink->wait_background_rotation();
+        REQUIRE(count_gunzip_lines(ROTATING_LOG ".1.gz") == 1);
+        REQUIRE_FALSE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T(ROTATING_LOG ".1")));
+    }
+
+    // disabling it disables the compression
+    prepare_logdir();
+    spdlog::filename_t basename = SPDLOG_FILENAME_T(ROTATING_LOG);
+    auto sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(basename, 1024, 2);
+    sink->set_compression(compression);
+    sink->set_background_rotation(false);
+    spdlog::logger logger("rotating_sink_logger", sink);
+    logger.info("Test message");
+    sink->rotate_now();
+    REQUIRE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T(ROTATING_LOG ".1")));
+    REQUIRE_FALSE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T(ROTATING_LOG ".1.gz")));
+}
+
+TEST_CASE("rotating_file_logger live compression", "[rotating_logger]") {
+    prepare_logdir();
+    spdlog::filename_t basename = SPDLOG_FILENAME_T(ROTATING_LOG ".gz");
+    auto sink = std::make_shared<spdlog::sinks::rotating_file_sink_st>(basename, 1024 * 1024, 1);
+    spdlog::file_compression compression;
+    compression.mode = spdlog::compression_mode::live;
+    sink->set_compression(compression);
+    auto logger = std::make_shared<spdlog::logger>("rotating_sink_logger", sink);
+    logger->set_pattern("%v");
+    for (int i = 0; i < 100; i++) {
+        logger->info("Test message {}", i);
+    }
+    // everything logged before the flush can be decompressed
+    logger->flush();
+    REQUIRE(count_gunzip_lines(ROTATING_LOG ".gz") == 100);
+
+    logger->info("Test message 100");
+    sink->rotate_now();
+    logger->info("Test message 0");
+    logger.reset();
+    sink.reset();
+    REQUIRE(count_gunzip_lines(ROTATING_LOG ".1.gz") == 101);
+    REQUIRE(gunzip_contents(ROTATING_LOG ".gz") == spdlog::fmt_lib::format("Test message 0{}", spdlog::details::os::default_eol));
+}
+#else
+TEST_CASE("rotating_file_logger compression not available", "[rotating_logger]") {
+    prepare_logdir();
+    spdlog::filename_t basename = SPDLOG_FILENAME_T(ROTATING_LOG);
+    spdlog::sinks::rotating_file_sink_st sink(basename, 1024, 2);
+    spdlog::file_compression compression;
+    compression.mode = spdlog::compression_mode::rotated;
+    REQUIRE_THROWS_AS(sink.set_compression(compression), spdlog::spdlog_ex);
+}
+#endif
+
+#ifdef __linux__
+TEST_CASE("uring_file_sink", "[uring_file_sink]") {
+    prepare_logdir();
+    spdlog::filename_t filename = SPDLOG_FILENAME_T("test_logs/uring_log.txt");
+    spdlog::file_event_handlers handlers;
+    handlers.after_open = [](spdlog::filename_t, std::FILE *fstream) { fputs("header\n", fstream); };
+    handlers.before_close = [](spdlog::filename_t, std::FILE *fstream) { fputs("footer\n", fstream); };
+    {
+        // small buffers so many writes are in flight
+        auto sink = std::make_shared<spdlog::sinks::uring_file_sink_mt>(filename, true, handlers, 256, 3);
+        spdlog::logger logger("uring_logger", sink);
+        logger.set_pattern("%v");
+        for (int i = 0; i < 1000; i++) {
+            logger.info("Test message {}", i);
+        }
+        logger.info(std::string(300, 'x'));  // larger than the buffers
+        logger.info("last");
+        logger.flush();
+        REQUIRE(count_lines("test_logs/uring_log.txt") == 1003);
+        sink->sync();
+    }
+    std::ifstream ifs("test_logs/uring_log.txt");
+    std::string line;
+    std::getline(ifs, line);
+    REQUIRE(line == "header");
+    for (int i = 0; i < 1000; i++) {
+        std::getline(ifs, line);
+        REQUIRE(line == spdlog::fmt_lib::format("Test message {}", i));
+    }
+    std::getline(ifs, line);
+    REQUIRE(line == std::string(300, 'x'));
+    std::getline(ifs, line);
+    REQUIRE(line == "last");
+    std::getline(ifs, line);
+    REQUIRE(line == "footer");
+}
+#endif
+
+#ifndef _WIN32
+TEST_CASE("mmap_file_sink", "[mmap_file_sink]") {
+    prepare_logdir();
+    spdlog::filename_t filename = SPDLOG_FILENAME_T("test_logs/mmap_log.txt");
+    spdlog::file_event_handlers handlers;
+    handlers.after_open = [](spdlog::filename_t, std::FILE *fstream) { fputs("header\n", fstream); };
+    handlers.before_close = [](spdlog::filename_t, std::FILE *fstream) { fputs("footer\n", fstream); };
+    std::string expected = "header\n";
+    {
+        // one page windows so the mapping rolls many times
+        auto sink = std::make_shared<spdlog::sinks::mmap_file_sink_mt>(filename, 1024 * 1024, 0, handlers, 1);
+        spdlog::logger logger("mmap_logger", sink);
+        logger.set_pattern("%v");
+        for (int i = 0; i < 1000; i++) {
+            logger.info("Test message {}", i);
+            expected += spdlog::fmt_lib::format("Test message {}{}", i, spdlog::details::os::default_eol);
+        }
+        logger.flush();
+        sink->sync();
+        // readable while the sink is open
+        REQUIRE(file_contents("test_logs/mmap_log.txt").substr(0, expected.size()) == expected);
+    }
+    // truncated to the written size on close
+    expected += "footer\n";
+    REQUIRE(file_contents("test_logs/mmap_log.txt") == expected);
+
+    // appends to the existing file
+    {
+        auto logger = spdlog::mmap_logger_st("mmap_logger", filename, 1024 * 1024, 0);
+        logger->set_pattern("%v");
+        logger->info("appended");
+    }
+    REQUIRE(file_contents("test_logs/mmap_log.txt") == expected + "appended" + spdlog::details::os::default_eol);
+}
+
+TEST_CASE("mmap_file_sink rotation", "[mmap_file_sink]") {
+    prepare_logdir();
+    spdlog::filename_t basename = SPDLOG_FILENAME_T("test_logs/mmap_rotate.txt");
+    {
+        auto logger = spdlog::mmap_logger_mt("mmap_logger", basename, 1024, 2);
+        logger->set_pattern("%v");
+        for (int i = 0; i < 200; i++) {
+            logger->info("Test message {}", i);
+        }
+    }
+    REQUIRE(get_filesize("test_logs/mmap_rotate.txt") <= 1024);
+    REQUIRE(get_filesize("test_logs/mmap_rotate.1.txt") <= 1024);
+    REQUIRE(get_filesize("test_logs/mmap_rotate.1.txt") > 1000);
+    REQUIRE(get_filesize("test_logs/mmap_rotate.2.txt") > 1000);
+    REQUIRE_FALSE(spdlog::details::os::path_exists(SPDLOG_FILENAME_T("test_logs/mmap_rotate.3.txt")));
+    const auto last = file_contents("test_logs/mmap_rotate.txt");
+    const auto last_line = spdlog::fmt_lib::format("Test message 199{}", spdlog::details::os::default_eol);
+    REQUIRE(last.substr(last.size() - last_line.size()) == last_line);
+}
+#endif
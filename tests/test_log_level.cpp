@@ -30,6 +30,84 @@ TEST_CASE("test_sink_levels", "[log_level]") {
     }
 }
 
+// counts how many times it was formatted
+struct format_counter {
+    int *count;
+};
+
+template <>
+struct fmt::formatter<format_counter> : fmt::formatter<int> {
+    auto format(const format_counter &c, format_context &ctx) const -> decltype(ctx.out()) {
+        return fmt::formatter<int>::format(++*c.count, ctx);
+    }
+};
+
+TEST_CASE("test_effective_level", "[log_level]") {
+    auto sink1 = std::make_shared<spdlog::sinks::test_sink_st>();
+    auto sink2 = std::make_shared<spdlog::sinks::test_sink_st>();
+    sink1->set_level(spdlog::level::warn);
+    sink2->set_level(spdlog::level::err);
+    spdlog::logger logger("test-effective", {sink1, sink2});
+    logger.set_level(spdlog::level::trace);
+    REQUIRE(logger.log_level() == spdlog::level::trace);
+    REQUIRE(logger.effective_level() == spdlog::level::warn);
+
+    // no sink accepts debug: rejected before formatting
+    int count = 0;
+    logger.debug("{}", format_counter{&count});
+    REQUIRE_FALSE(logger.should_log(spdlog::level::debug));
+    REQUIRE(count == 0);
+    logger.warn("{}", format_counter{&count});
+    REQUIRE(count == 1);
+    REQUIRE(sink1->msg_counter() == 1);
+    REQUIRE(sink2->msg_counter() == 0);
+
+    // recomputed after sink level changes
+    sink2->set_level(spdlog::level::debug);
+    REQUIRE(logger.effective_level() == spdlog::level::debug);
+    logger.debug("{}", format_counter{&count});
+    REQUIRE(count == 2);
+    REQUIRE(sink2->msg_counter() == 1);
+
+    // after logger level changes
+    logger.set_level(spdlog::level::critical);
+    REQUIRE(logger.effective_level() == spdlog::level::critical);
+
+    // and after sink changes
+    logger.set_level(spdlog::level::trace);
+    auto sink3 = std::make_shared<spdlog::sinks::test_sink_st>();
+    logger.add_sink(sink3);
+    REQUIRE(logger.effective_level() == spdlog::level::trace);
+    logger.remove_sink(sink3);
+    REQUIRE(logger.effective_level() == spdlog::level::debug);
+    logger.remove_sink(sink1);
+    logger.remove_sink(sink2);
+    REQUIRE(static_cast<const spdlog::logger &>(logger).sinks().empty());
+    REQUIRE(logger.effective_level() == spdlog::level::off);
+}
+
+TEST_CASE("test_effective_level mutable sinks", "[log_level]") {
+    auto sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    sink->set_level(spdlog::level::err);
+    spdlog::logger logger("test-effective", sink);
+    logger.set_level(spdlog::level::info);
+    REQUIRE(logger.effective_level() == spdlog::level::err);
+
+    // the sinks may change through the reference at any time: only the logger's level is used
+    auto &sinks = logger.sinks();
+    REQUIRE(logger.effective_level() == spdlog::level::info);
+    sinks.push_back(std::make_shared<spdlog::sinks::test_sink_st>());
+    logger.info("hello");
+    REQUIRE(sink->msg_counter() == 0);
+    REQUIRE(std::static_pointer_cast<spdlog::sinks::test_sink_st>(sinks[1])->msg_counter() == 1);
+    sinks.clear();
+    REQUIRE(logger.effective_level() == spdlog::level::info);
+
+    // a logger without sinks rejects everything
+    spdlog::logger empty("test-empty");
+    REQUIRE(empty.effective_level() == spdlog::level::off);
+}
+
 //
 // test helpers to check that logger/sink displays only messages with level bigger or equal to its
 // level
@@ -5,6 +5,7 @@
 
 #include "includes.h"
 #include "spdlog/sinks/basic_file_sink.h"
+#include "test_sink.h"
 
 #if SPDLOG_ACTIVE_LEVEL != SPDLOG_LEVEL_DEBUG
     #error "Invalid SPDLOG_ACTIVE_LEVEL in test. Should be SPDLOG_LEVEL_DEBUG"
@@ -49,3 +50,45 @@ TEST_CASE("pass logger pointer", "[macros]") {
     SPDLOG_LOGGER_TRACE(&ref, "Test message 1");
     SPDLOG_LOGGER_DEBUG(&ref, "Test message 2");
 }
+
+TEST_CASE("lazy macros", "[macros]") {
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    auto logger = std::make_shared<spdlog::logger>("lazy", test_sink);
+    logger->set_pattern("%v");
+    logger->set_level(spdlog::level::info);
+
+    int evaluated = 0;
+    auto costly = [&evaluated] { return ++evaluated; };
+    // disabled at runtime: the arguments are not evaluated (by the regular macros either, see call_site.h)
+    SPDLOG_LOGGER_DEBUG_LAZY(logger, "Test message {}", costly());
+    SPDLOG_LOGGER_DEBUG(logger, "Test message {}", costly());
+    REQUIRE(evaluated == 0);
+    REQUIRE(test_sink->msg_counter() == 0);
+
+    SPDLOG_LOGGER_INFO_LAZY(logger, "Test message {}", costly());
+    REQUIRE(evaluated == 1);
+    REQUIRE(test_sink->lines() == std::vector<std::string>{"Test message 1"});
+
+    // the logger expression is evaluated once
+    int logger_evaluated = 0;
+    SPDLOG_LOGGER_WARN_LAZY((logger_evaluated++, logger), "Test message");
+    REQUIRE(logger_evaluated == 1);
+    REQUIRE(test_sink->msg_counter() == 2);
+
+    // compiled out
+    SPDLOG_LOGGER_TRACE_LAZY(logger, "Test message {}", throw std::runtime_error("Should not be evaluated"));
+}
+
+TEST_CASE("log_lazy", "[macros]") {
+    auto test_sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    spdlog::logger logger("lazy", test_sink);
+    logger.set_pattern("%v");
+
+    int evaluated = 0;
+    logger.log_lazy(spdlog::level::debug, [&] { return std::to_string(++evaluated); });
+    REQUIRE(evaluated == 0);
+    logger.log_lazy(spdlog::level::info, [&] { return "Test message " + std::to_string(++evaluated); });
+    logger.log_lazy(spdlog::level::warn, [] { return "Test message 2"; });
+    REQUIRE(evaluated == 1);
+    REQUIRE(test_sink->lines() == std::vector<std::string>{"Test message 1", "Test message 2"});
+}
@@ -33,6 +33,31 @@ TEST_CASE("basic_logging ", "[basic_logging]") {
     REQUIRE(log_info(std::string()).empty());
 }
 
+// logs to another logger while being formatted
+struct logging_arg {
+    spdlog::logger *inner;
+};
+
+template <>
+struct fmt::formatter<logging_arg> : fmt::formatter<std::string_view> {
+    auto format(const logging_arg &arg, format_context &ctx) const -> decltype(ctx.out()) {
+        arg.inner->info("inner {}", std::string(300, 'i'));
+        return fmt::formatter<std::string_view>::format("arg", ctx);
+    }
+};
+
+TEST_CASE("nested logging", "[basic_logging]") {
+    // both messages are larger than memory_buf_t's inline storage: the nested one can't reuse the thread's buffer
+    auto sink = std::make_shared<spdlog::sinks::test_sink_st>();
+    spdlog::logger outer("outer", sink);
+    spdlog::logger inner("inner", sink);
+    outer.set_pattern("%v");
+    outer.info("outer {} {}", std::string(300, 'o'), logging_arg{&inner});
+    REQUIRE(sink->lines().size() == 2);
+    REQUIRE(sink->lines()[0] == "inner " + std::string(300, 'i'));
+    REQUIRE(sink->lines()[1] == "outer " + std::string(300, 'o') + " arg");
+}
+
 TEST_CASE("log_levels", "[log_levels]") {
     REQUIRE(log_info("Hello", spdlog::level::err).empty());
     REQUIRE(log_info("Hello", spdlog::level::critical).empty());
@@ -19,4 +19,13 @@ TEST_CASE("test_no_source_location", "[source_location]") {
     SPDLOG_LOGGER_CALL(logger, spdlog::level::info, "Hello");
     REQUIRE(test_sink->lines().size() == 2);
     REQUIRE(test_sink->lines()[1] == ":: Hello");
+
+    // the arguments are evaluated only if the call logs
+    int evaluated = 0;
+    logger->set_level(spdlog::level::warn);
+    SPDLOG_LOGGER_CALL(logger, spdlog::level::info, "Hello {}", ++evaluated);
+    REQUIRE(evaluated == 0);
+    SPDLOG_LOGGER_CALL(logger, spdlog::level::warn, "Hello {}", ++evaluated);
+    REQUIRE(evaluated == 1);
+    REQUIRE(test_sink->lines().size() == 3);
 }
@@ -455,3 +455,64 @@ TEST_CASE("override need_localtime", "[pattern_formatter]") {
         REQUIRE(to_string_view(formatted) == oss.str());
     }
 }
+
+TEST_CASE("key/value fields", "[pattern_formatter]") {
+    std::ostringstream oss;
+    auto oss_sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(oss);
+    spdlog::logger oss_logger("pattern_tester", oss_sink);
+    oss_logger.set_pattern("%v [%V]");
+
+    std::string side = "buy";
+    oss_logger.info("order filled", spdlog::kv("id", 42), spdlog::kv("qty", 7u), spdlog::kv("px", 1.5), spdlog::kv("side", side),
+                    spdlog::kv("ok", true));
+    oss_logger.info("no fields");
+    std::string eol = spdlog::details::os::default_eol;
+    REQUIRE(oss.str() == "order filled [id=42 qty=7 px=1.5 side=buy ok=true]" + eol + "no fields []" + eol);
+}
+
+TEST_CASE("key/value fields padding", "[pattern_formatter]") {
+    std::ostringstream oss;
+    auto oss_sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(oss);
+    spdlog::logger oss_logger("pattern_tester", oss_sink);
+    oss_logger.set_pattern("[%-10V]");
+    oss_logger.info("msg", spdlog::kv("a", 1));
+    REQUIRE(oss.str() == std::string("[a=1       ]") + spdlog::details::os::default_eol);
+}
+
+TEST_CASE("mdc formatter", "[pattern_formatter]") {
+    auto formatter = std::make_shared<spdlog::pattern_formatter>("[%&] %v", spdlog::pattern_time_type::local, "\n");
+    {
+        spdlog::mdc_guard g1("request_id", "123");
+        spdlog::mdc_guard g2("tenant", "acme");
+        memory_buf_t formatted;
+        spdlog::details::log_msg msg(spdlog::source_loc{}, "logger-name", spdlog::level::info, "some message");
+        formatter->format(msg, formatted);
+        REQUIRE(to_string_view(formatted) == "[request_id=123 tenant=acme] some message\n");
+
+        // nested guard overrides the value and restores it on destruction
+        {
+            spdlog::mdc_guard g3("tenant", "other");
+            REQUIRE(spdlog::mdc::get("tenant") == "other");
+        }
+        REQUIRE(spdlog::mdc::get("tenant") == "acme");
+    }
+    REQUIRE(spdlog::mdc::current() == nullptr);
+
+    memory_buf_t formatted;
+    spdlog::details::log_msg msg(spdlog::source_loc{}, "logger-name", spdlog::level::info, "some message");
+    formatter->format(msg, formatted);
+    REQUIRE(to_string_view(formatted) == "[] some message\n");
+}
+
+TEST_CASE("mdc put/remove", "[pattern_formatter]") {
+    spdlog::mdc::put("a", "1");
+    spdlog::mdc::put("b", "2");
+    const auto *snapshot = spdlog::mdc::current();
+    // snapshot doesn't change if the context didn't change
+    REQUIRE(spdlog::mdc::current() == snapshot);
+    spdlog::mdc::remove("a");
+    REQUIRE(spdlog::mdc::get("a").empty());
+    REQUIRE(spdlog::mdc::get("b") == "2");
+    spdlog::mdc::clear();
+    REQUIRE(spdlog::mdc::current() == nullptr);
+}
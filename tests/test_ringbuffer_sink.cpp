@@ -68,4 +68,84 @@ TEST_CASE("test_empty_size", "[ringbuffer_sink]") {
     sink->drain([&](std::string_view) {
         REQUIRE_FALSE(true);  // should not be called since the sink size is 0
     });
-}
\ No newline at end of file
+}
+
+TEST_CASE("test_arena_size", "[ringbuffer_sink]") {
+    // limited by arena size only - old messages are overwritten as the arena wraps around
+    const size_t arena_size = 4096;
+    auto sink = std::make_shared<spdlog::sinks::ringbuffer_sink_mt>(std::numeric_limits<size_t>::max(), arena_size);
+    spdlog::logger l("logger", sink);
+    l.set_pattern("%v");
+
+    int next_expected = -1;
+    for (int i = 0; i < 500; i++) {
+        l.info("{} {}", i, std::string(static_cast<size_t>(i % 97), 'x'));
+        if (i % 50 != 49) {
+            continue;
+        }
+        // the ring holds the newest messages, in order
+        int last = -1;
+        size_t count = 0;
+        sink->drain([&](std::string_view msg) {
+            int n = std::stoi(std::string(msg.substr(0, msg.find(' '))));
+            REQUIRE(n > last);
+            REQUIRE(n > next_expected);
+            last = n;
+            count++;
+        });
+        REQUIRE(count > 0);
+        REQUIRE(last == i);
+        next_expected = i;
+    }
+}
+
+TEST_CASE("test_drain_raw_fields", "[ringbuffer_sink]") {
+    auto sink = std::make_shared<spdlog::sinks::ringbuffer_sink_mt>(2, 1024);
+    spdlog::logger l("logger", sink);
+    for (int i = 0; i < 5; i++) {
+        l.info("order", spdlog::kv("id", i), spdlog::kv("side", std::string("buy")));
+    }
+
+    int counter = 3;
+    sink->drain_raw([&](const spdlog::details::log_msg_buffer &buffer) {
+        REQUIRE(buffer.logger_name == "logger");
+        REQUIRE(buffer.payload == "order");
+        REQUIRE(buffer.fields_count == 2);
+        REQUIRE(buffer.fields[0].key == "id");
+        REQUIRE(buffer.fields[0].value.int_value == counter);
+        REQUIRE(buffer.fields[1].string_value() == "buy");
+        counter++;
+    });
+    REQUIRE(counter == 5);
+}
+
+TEST_CASE("test_too_large", "[ringbuffer_sink]") {
+    auto sink = std::make_shared<spdlog::sinks::ringbuffer_sink_mt>(10, 512);
+    spdlog::logger l("logger", sink);
+    l.set_pattern("%v");
+    l.info("small");
+    l.info(std::string(1024, 'x'));  // larger than the whole arena - dropped
+
+    std::vector<std::string> messages;
+    sink->drain([&](std::string_view msg) { messages.emplace_back(msg); });
+    REQUIRE(messages.size() == 1);
+    REQUIRE(messages[0] == spdlog::fmt_lib::format("small{}", spdlog::details::os::default_eol));
+}
+
+TEST_CASE("test_large_messages", "[ringbuffer_sink]") {
+    // without an arena size, n_items messages of any size are kept
+    auto sink = std::make_shared<spdlog::sinks::ringbuffer_sink_mt>(3);
+    spdlog::logger l("logger", sink);
+    l.set_pattern("%v");
+    for (int i = 0; i < 4; i++) {
+        l.info("{} {}", i, std::string(4096, 'x'));
+    }
+
+    int counter = 1;
+    sink->drain([&](std::string_view msg) {
+        REQUIRE(msg.size() == 4096 + 2 + std::strlen(spdlog::details::os::default_eol));
+        REQUIRE(msg[0] == '0' + counter);
+        counter++;
+    });
+    REQUIRE(counter == 4);
+}
@@ -81,3 +81,97 @@ TEST_CASE("stderr_color_mt", "[stderr]") {
     l->error("Test stderr_color_mt");
     l->critical("Test stderr_color_mt");
 }
+
+#ifndef _WIN32
+// not a terminal: the messages stay in the stdio buffer up to the flush interval
+TEST_CASE("stdout_sink_base not a terminal", "[stdout]") {
+    FILE *file = std::tmpfile();
+    REQUIRE(file != nullptr);
+    {
+        spdlog::sinks::stdout_sink_base<spdlog::details::null_mutex> sink(file);
+        REQUIRE_FALSE(sink.line_flush());
+        sink.set_flush_interval(std::chrono::milliseconds(50));
+        sink.log(spdlog::details::log_msg{"test", spdlog::level::info, "first"});
+        REQUIRE(spdlog::details::os::filesize(file) == 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(60));
+        sink.log(spdlog::details::log_msg{"test", spdlog::level::info, "second"});
+        const auto size = spdlog::details::os::filesize(file);
+        REQUIRE(size > 0);
+
+        sink.set_flush_interval(std::chrono::milliseconds::zero());
+        REQUIRE(sink.line_flush());
+        sink.log(spdlog::details::log_msg{"test", spdlog::level::info, "third"});
+        REQUIRE(spdlog::details::os::filesize(file) > size);
+    }
+
+    // _mt: flushed by the timer thread
+    {
+        spdlog::sinks::stdout_sink_base<std::mutex> sink(file);
+        sink.set_flush_interval(std::chrono::milliseconds(10));
+        const auto size = spdlog::details::os::filesize(file);
+        sink.log(spdlog::details::log_msg{"test", spdlog::level::info, "fourth"});
+        for (int i = 0; i < 200 && spdlog::details::os::filesize(file) == size; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        REQUIRE(spdlog::details::os::filesize(file) > size);
+    }
+    std::fclose(file);
+}
+
+// the timer thread is started by the first message left in the stdio buffer, not by the sink
+TEST_CASE("console_flusher lazy timer", "[stdout]") {
+    FILE *file = std::tmpfile();
+    REQUIRE(file != nullptr);
+    std::mutex mutex;
+    {
+        spdlog::details::console_flusher flusher(file, spdlog::details::console_flusher::locked_flush(mutex, file));
+        REQUIRE_FALSE(flusher.line_flush());
+        REQUIRE_FALSE(flusher.timer_started());
+        flusher.written(spdlog::log_clock::now());
+        REQUIRE(flusher.timer_started());
+
+        // a new interval drops the timer until the next message
+        auto previous_timer = flusher.set_interval(std::chrono::milliseconds(10));
+        REQUIRE(previous_timer != nullptr);
+        REQUIRE_FALSE(flusher.timer_started());
+        flusher.stop();
+    }
+
+    // no timer for the _st sinks, nor when every message is flushed
+    spdlog::details::null_mutex null_mutex;
+    spdlog::details::console_flusher flusher_st(file, spdlog::details::console_flusher::locked_flush(null_mutex, file));
+    flusher_st.written(spdlog::log_clock::now());
+    REQUIRE_FALSE(flusher_st.timer_started());
+
+    spdlog::details::console_flusher flusher_mt(file, spdlog::details::console_flusher::locked_flush(mutex, file));
+    REQUIRE(flusher_mt.set_interval(std::chrono::milliseconds::zero()) == nullptr);
+    flusher_mt.written(spdlog::log_clock::now());
+    REQUIRE_FALSE(flusher_mt.timer_started());
+    std::fclose(file);
+}
+
+// one write per message, with the escape codes spliced in
+TEST_CASE("ansicolor_sink colors", "[stdout]") {
+    using ansicolor_sink_st = spdlog::sinks::ansicolor_sink<spdlog::details::null_mutex>;
+    FILE *file = std::tmpfile();
+    REQUIRE(file != nullptr);
+    {
+        ansicolor_sink_st sink(file, spdlog::color_mode::always);
+        sink.set_pattern("[%^%l%$] %v");
+        REQUIRE_FALSE(sink.line_flush());
+        sink.log(spdlog::details::log_msg{"test", spdlog::level::info, "hello"});
+        REQUIRE(spdlog::details::os::filesize(file) == 0);
+        sink.log(spdlog::details::log_msg{"test", spdlog::level::err, "world"});
+        sink.flush();
+    }
+    const std::string eol = spdlog::details::os::default_eol;
+    const std::string expected = "[" + std::string(ansicolor_sink_st::green) + "info" + std::string(ansicolor_sink_st::reset) +
+                                 "] hello" + eol + "[" + std::string(ansicolor_sink_st::red_bold) + "error" +
+                                 std::string(ansicolor_sink_st::reset) + "] world" + eol;
+    std::string content(expected.size() + 1, '\0');
+    std::rewind(file);
+    content.resize(std::fread(&content[0], 1, content.size(), file));
+    REQUIRE(content == expected);
+    std::fclose(file);
+}
+#endif